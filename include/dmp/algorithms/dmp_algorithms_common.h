@@ -58,8 +58,11 @@
 #include "dmp/types/dmp_diff.h"
 #include "dmp/types/dmp_settings.h"
 #include "dmp/utils/dmp_encoding.h"
+#include "dmp/utils/dmp_simd.h"
 #include "dmp/utils/dmp_stringpool_base.h"
 
+#include <type_traits>
+
 namespace dmp {
 
 
@@ -93,6 +96,8 @@ struct diff_match_patch_common {
 
 
     using Operation = types::Operation;
+    using Cleanup   = types::Cleanup;
+    using LineDiff  = types::LineDiff;
 
     using diff_t = types::diff<string_traits>;
 
@@ -140,14 +145,7 @@ public:
         using namespace dmp::utils;
 
         auto n = min(text1.length(), text2.length());
-        auto d1(text1.data());
-        auto d2(text2.data());
-        for (decltype(n) i = 0; i < n; i++) {
-            if (d1[i] != d2[i]) {
-                return i;
-            }
-        }
-        return n;
+        return commonPrefixLength(text1.data(), text2.data(), n);
     }
 
     /**
@@ -164,14 +162,7 @@ public:
         auto text1_length(text1.length());
         auto text2_length(text2.length());
         auto n = min(text1_length, text2_length);
-        auto d1(text1.data());
-        auto d2(text2.data());
-        for (decltype(n) i = 1; i <= n; i++) {
-            if (d1[text1_length - i] != d2[text2_length - i]) {
-                return i - 1;
-            }
-        }
-        return n;
+        return commonSuffixLength(text1.data() + text1_length, text2.data() + text2_length, n);
     }
 
 
@@ -204,10 +195,51 @@ public:
             return text_length;
         }
 
-        // Start by looking for a single character match
+        // Quick check for no overlap at all.
+        if (text2.indexOf(text1.substring(text_length - 1)) == npos) {
+            return 0;
+        }
+
+        // Hash the suffix of text1 and the prefix of text2 of each length in
+        // a single pass and keep the longest length where they match, which
+        // is linear even for long runs of similar characters.  Two hashes
+        // modulo primes below 2^31 make collisions unlikely, the result is
+        // verified anyway.
+        constexpr const uint64_t mod1  = 2147483647u;
+        constexpr const uint64_t mod2  = 2147483629u;
+        constexpr const uint64_t base1 = 911382323u;
+        constexpr const uint64_t base2 = 972663749u;
+
+        auto     d1(text1.data());
+        auto     d2(text2.data());
+        uint64_t suffix1 = 0;
+        uint64_t suffix2 = 0;
+        uint64_t prefix1 = 0;
+        uint64_t prefix2 = 0;
+        uint64_t power1  = 1;
+        uint64_t power2  = 1;
+        size_t   best    = 0;
+        for (size_t length = 1; length < text_length; length++) {
+            uint64_t c1 = static_cast<uint64_t>(static_cast<std::make_unsigned_t<char_t>>(d1[text_length - length]));
+            uint64_t c2 = static_cast<uint64_t>(static_cast<std::make_unsigned_t<char_t>>(d2[length - 1]));
+            suffix1     = (c1 % mod1 * power1 + suffix1) % mod1;
+            suffix2     = (c1 % mod2 * power2 + suffix2) % mod2;
+            prefix1     = (prefix1 * base1 + c2 % mod1) % mod1;
+            prefix2     = (prefix2 * base2 + c2 % mod2) % mod2;
+            power1      = power1 * base1 % mod1;
+            power2      = power2 * base2 % mod2;
+            if (suffix1 == prefix1 && suffix2 == prefix2) {
+                best = length;
+            }
+        }
+        if (text1.substring(text_length - best) == text2.substring(0, best)) {
+            return best;
+        }
+
+        // Hash collision, start by looking for a single character match
         // and increase length until no match is found.
         // Performance analysis: https://neil.fraser.name/news/2010/11/04/
-        size_t best   = 0;
+        best          = 0;
         size_t length = 1;
         while (true) {
             string_view_t pattern = text1.substring(text_length - length);
@@ -226,38 +258,166 @@ public:
     }
 
 
+    /**
+     * Count the hunks of a diff.  A hunk is a run of changes together with
+     * the equality that follows it, equalities before the first change
+     * belong to the first hunk.
+     * @param diffs List of Diff objects.
+     * @return Number of hunks, 1 for a diff without changes.
+     */
+public:
+    inline static constexpr size_t diff_hunkCount(const diffs_t& diffs) noexcept {
+        size_t begin = 0;
+        size_t end   = 0;
+        return diffs.empty() ? 0 : diff_hunkRange(diffs, npos, 0, begin, end) + 1;
+    }
+
     /**
      * Convert a Diff list into a pretty HTML report.
      * @param diffs List of Diff objects.
+     * @param firstHunk First hunk to render, see diff_hunkCount.
+     * @param hunkCount Number of hunks to render.
      * @return HTML representation.
      */
 public:
     template <typename Stream>
-    inline static constexpr Stream& diff_prettyHtml(Stream& s, const diffs_t& diffs) noexcept {
+    inline static constexpr Stream& diff_prettyHtml(Stream& s, const diffs_t& diffs, size_t firstHunk = 0, size_t hunkCount = npos) noexcept {
         using namespace dmp::utils;
 
-        for (auto& d : diffs) {
+        diff_walkPrettyHtml(diffs, firstHunk, hunkCount, [&s](const string_view_t& piece) { writeToStream(s, piece); });
+        return s;
+    }
+
+    /**
+     * Convert a Diff list into a pretty HTML report in a buffer.
+     * diff_prettyHtmlLength tells the size the buffer needs.
+     * @param buffer Buffer receiving the report.
+     * @param size Size of the buffer on input, length of the report on output.
+     * @param diffs List of Diff objects.
+     * @param firstHunk First hunk to render, see diff_hunkCount.
+     * @param hunkCount Number of hunks to render.
+     * @return false if the report was cut off at the end of the buffer.
+     */
+public:
+    inline static constexpr bool diff_prettyHtml(char_t* buffer, size_t& size, const diffs_t& diffs, size_t firstHunk = 0, size_t hunkCount = npos) noexcept {
+        using namespace dmp::utils;
+
+        auto   p(buffer);
+        size_t l(size);
+        bool   fits = true;
+        diff_walkPrettyHtml(diffs, firstHunk, hunkCount, [&p, &l, &fits](const string_view_t& piece) {
+            fits = fits && piece.length() <= l;
+            str_copy(p, l, piece);
+        });
+        size -= l;
+        return fits;
+    }
+
+    /**
+     * Compute the length of the pretty HTML report without building it.
+     * @param diffs List of Diff objects.
+     * @param firstHunk First hunk to render, see diff_hunkCount.
+     * @param hunkCount Number of hunks to render.
+     * @return Length of the HTML representation.
+     */
+public:
+    inline static constexpr size_t diff_prettyHtmlLength(const diffs_t& diffs, size_t firstHunk = 0, size_t hunkCount = npos) noexcept {
+        size_t length = 0;
+        diff_walkPrettyHtml(diffs, firstHunk, hunkCount, [&length](const string_view_t& piece) { length += piece.length(); });
+        return length;
+    }
+
+    /**
+     * Find the diffs of a window of hunks.
+     * @param diffs List of Diff objects.
+     * @param firstHunk First hunk of the window.
+     * @param hunkCount Number of hunks in the window.
+     * @param begin Index of the first diff of the window.
+     * @param end Index after the last diff of the window.
+     * @return Index of the last hunk seen.
+     */
+private:
+    inline static constexpr size_t diff_hunkRange(const diffs_t& diffs, size_t firstHunk, size_t hunkCount, size_t& begin, size_t& end) noexcept {
+        size_t n       = diffs.size();
+        size_t hunk    = 0;
+        bool   changed = false;
+
+        begin = n;
+        end   = n;
+        for (size_t i = 0; i < n; i++) {
+            if (diffs[i].operation != Operation::EQUAL) {
+                if (changed && diffs[i - 1].operation == Operation::EQUAL) {
+                    hunk++;
+                }
+                changed = true;
+            }
+            if (hunk >= firstHunk) {
+                if (hunk - firstHunk >= hunkCount) {
+                    end = i;
+                    break;
+                }
+                if (begin == n) {
+                    begin = i;
+                }
+            }
+        }
+        if (begin > end) {
+            begin = end;
+        }
+        return hunk;
+    }
+
+    /**
+     * Walk a window of hunks and pass the pieces of the pretty HTML report in
+     * order to the callback, tags and escapes as literals and plain text as
+     * views into the diffs.
+     * @param diffs List of Diff objects.
+     * @param firstHunk First hunk to render.
+     * @param hunkCount Number of hunks to render.
+     * @param piece Callback taking a string_view_t.
+     */
+private:
+    template <typename Callback>
+    inline static constexpr void diff_walkPrettyHtml(const diffs_t& diffs, size_t firstHunk, size_t hunkCount, Callback&& piece) noexcept {
+        using namespace dmp::utils;
+
+        using tags = pretty_html_tags;
+
+        size_t begin = 0;
+        size_t end   = 0;
+        diff_hunkRange(diffs, firstHunk, hunkCount, begin, end);
+        for (size_t i = begin; i < end; i++) {
+            auto& d(diffs[i]);
             switch (d.operation) {
                 case Operation::INSERT:
-                    char_traits::write(s, "<ins style=\"background:#e6ffe6;\">");
-                    writeHtml<char_traits>(s, d.text);
-                    char_traits::write(s, "</ins>");
+                    piece(string_view_t(tags::insOpen.chars, tags::insOpen.length));
+                    forEachHtmlPiece<char_traits>(d.text, piece);
+                    piece(string_view_t(tags::insClose.chars, tags::insClose.length));
                     break;
                 case Operation::DELETE:
-                    char_traits::write(s, "<del style=\"background:#ffe6e6;\">");
-                    writeHtml<char_traits>(s, d.text);
-                    char_traits::write(s, "</del>");
+                    piece(string_view_t(tags::delOpen.chars, tags::delOpen.length));
+                    forEachHtmlPiece<char_traits>(d.text, piece);
+                    piece(string_view_t(tags::delClose.chars, tags::delClose.length));
                     break;
                 case Operation::EQUAL:
-                    char_traits::write(s, "<span>");
-                    writeHtml<char_traits>(s, d.text);
-                    char_traits::write(s, "</span>");
+                    piece(string_view_t(tags::spanOpen.chars, tags::spanOpen.length));
+                    forEachHtmlPiece<char_traits>(d.text, piece);
+                    piece(string_view_t(tags::spanClose.chars, tags::spanClose.length));
                     break;
             }
         }
-        return s;
     }
 
+private:
+    struct pretty_html_tags {
+        inline static constexpr auto insOpen   = utils::widen<char_t>("<ins style=\"background:#e6ffe6;\">");
+        inline static constexpr auto insClose  = utils::widen<char_t>("</ins>");
+        inline static constexpr auto delOpen   = utils::widen<char_t>("<del style=\"background:#ffe6e6;\">");
+        inline static constexpr auto delClose  = utils::widen<char_t>("</del>");
+        inline static constexpr auto spanOpen  = utils::widen<char_t>("<span>");
+        inline static constexpr auto spanClose = utils::widen<char_t>("</span>");
+    };
+
     /**
      * Compute and return the source text (all equalities and deletions).
      * @param diffs List of Diff objects.
@@ -447,6 +607,308 @@ public:
         return s;
     }
 
+    /**
+     * Crush the diff into a binary delta, the compact form of diff_toDelta.
+     * Each diff is written as a header, the number length * 4 + operation
+     * (0 for equality, 1 for deletion, 2 for insertion) in 7 bit digits,
+     * least significant first and one per character, with 0x80 set on all
+     * but the last digit.  Inserted text follows its header unchanged.
+     * @param diffs Array of Diff objects.
+     * @return Binary delta.
+     */
+public:
+    template <typename Stream>
+    inline static constexpr Stream& diff_toBinaryDelta(Stream& s, const diffs_t& diffs) noexcept {
+        using namespace dmp::utils;
+
+        for (auto& d : diffs) {
+            uint64_t header = static_cast<uint64_t>(d.text.length()) << 2;
+            switch (d.operation) {
+                case Operation::INSERT:
+                    header |= 2;
+                    break;
+                case Operation::DELETE:
+                    header |= 1;
+                    break;
+                case Operation::EQUAL:
+                    break;
+            }
+            while (header >= 0x80) {
+                char_traits::write(s, static_cast<char_t>((header & 0x7f) | 0x80));
+                header >>= 7;
+            }
+            char_traits::write(s, static_cast<char_t>(header));
+            if (d.operation == Operation::INSERT) {
+                writeToStream(s, d.text);
+            }
+        }
+        return s;
+    }
+
+    /**
+     * Write the diff in the unified format of GNU diff, hunks with
+     * contextLines lines of context each.  The diffs don't need to be split
+     * at line ends, a line with any change is shown as removed and added.
+     * Nothing is written if the texts are equal.
+     * @param diffs Array of Diff objects.
+     * @param fromFile Name of text1 for the --- line.
+     * @param toFile Name of text2 for the +++ line.
+     * @param contextLines Number of equal lines around each change.
+     * @return Unified diff.
+     */
+public:
+    template <typename Stream>
+    inline static constexpr Stream& diff_toUnified(Stream& s, const diffs_t& diffs, string_view_t fromFile, string_view_t toFile,
+                                                   size_t contextLines = 3) noexcept {
+        using namespace dmp::utils;
+
+        string_view_t  line;
+        unified_cursor c;
+        bool           first = true;
+        while (true) {
+            // Skip equal lines, the last contextLines of them lead into the hunk.
+            unified_cursor start(c);
+            size_t         equalLines = 0;
+            while (diff_unifiedEqualLine(diffs, c, line)) {
+                diff_unifiedSkipLine(c, line);
+                equalLines++;
+            }
+            if (c.index == diffs.size()) {
+                break;
+            }
+            for (size_t i = contextLines; i < equalLines; i++) {
+                diff_unifiedEqualLine(diffs, start, line);
+                diff_unifiedSkipLine(start, line);
+            }
+
+            // Extend the hunk over changes at most 2 * contextLines equal lines apart.
+            unified_cursor end(c);
+            while (true) {
+                diff_unifiedSkipChange(diffs, end);
+                unified_cursor next(end);
+                equalLines = 0;
+                while ((equalLines + 1) / 2 <= contextLines && diff_unifiedEqualLine(diffs, next, line)) {
+                    diff_unifiedSkipLine(next, line);
+                    equalLines++;
+                }
+                if ((equalLines + 1) / 2 > contextLines || next.index == diffs.size()) {
+                    for (size_t i = 0; i < equalLines && i < contextLines; i++) {
+                        diff_unifiedEqualLine(diffs, end, line);
+                        diff_unifiedSkipLine(end, line);
+                    }
+                    diff_unifiedNormalize(diffs, end);
+                    break;
+                }
+                end = next;
+            }
+
+            if (first) {
+                char_traits::write(s, "--- ");
+                writeToStream(s, fromFile);
+                char_traits::write(s, "\n+++ ");
+                writeToStream(s, toFile);
+                char_traits::write(s, '\n');
+                first = false;
+            }
+            char_traits::write(s, "@@ -");
+            diff_unifiedRange(s, start.line1, end.line1 - start.line1);
+            char_traits::write(s, " +");
+            diff_unifiedRange(s, start.line2, end.line2 - start.line2);
+            char_traits::write(s, " @@\n");
+
+            // Write the lines of the hunk.
+            c = start;
+            diff_unifiedNormalize(diffs, c);
+            while (c.index != end.index || c.offset != end.offset) {
+                if (diff_unifiedEqualLine(diffs, c, line)) {
+                    char_traits::write(s, ' ');
+                    diff_unifiedWriteLine(s, line);
+                    diff_unifiedSkipLine(c, line);
+                } else {
+                    unified_cursor changed(c);
+                    diff_unifiedSkipChange(diffs, changed);
+                    diff_unifiedWriteChange(s, diffs, c, changed, Operation::INSERT, '-');
+                    diff_unifiedWriteChange(s, diffs, c, changed, Operation::DELETE, '+');
+                    c = changed;
+                }
+                diff_unifiedNormalize(diffs, c);
+            }
+        }
+        return s;
+    }
+
+private:
+    /**
+     * Position in a diff list with the number of lines before it in text1
+     * and text2.
+     */
+    struct unified_cursor {
+        size_t index  = 0;
+        size_t offset = 0;
+        size_t line1  = 0;
+        size_t line2  = 0;
+    };
+
+    /**
+     * Check for an equal line at the cursor, which is at the start of a line
+     * in both texts.  The last line of the texts may miss its newline.
+     */
+private:
+    inline static constexpr bool diff_unifiedEqualLine(const diffs_t& diffs, unified_cursor& c, string_view_t& line) noexcept {
+        size_t n = diffs.size();
+        diff_unifiedNormalize(diffs, c);
+        if (c.index == n || diffs[c.index].operation != Operation::EQUAL) {
+            return false;
+        }
+
+        string_view_t rest = diffs[c.index].text.substring(c.offset);
+        size_t        p    = rest.indexOf(char_traits::eol);
+        if (p != npos) {
+            line = rest.substring(0, p + 1);
+            return true;
+        }
+        if (c.index + 1 == n) {
+            line = rest;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Move the cursor off the end of a diff, so that each position has one
+     * cursor.
+     */
+private:
+    inline static constexpr void diff_unifiedNormalize(const diffs_t& diffs, unified_cursor& c) noexcept {
+        while (c.index < diffs.size() && c.offset == diffs[c.index].text.length()) {
+            c.index++;
+            c.offset = 0;
+        }
+    }
+
+private:
+    inline static constexpr void diff_unifiedSkipLine(unified_cursor& c, const string_view_t& line) noexcept {
+        c.offset += line.length();
+        c.line1++;
+        c.line2++;
+    }
+
+    /**
+     * Move the cursor over the changed lines starting at it, up to the next
+     * equal line or the end.
+     */
+private:
+    inline static constexpr void diff_unifiedSkipChange(const diffs_t& diffs, unified_cursor& c) noexcept {
+        string_view_t line;
+        bool          atLine1 = true;
+        bool          atLine2 = true;
+        while (true) {
+            diff_unifiedNormalize(diffs, c);
+            if (c.index == diffs.size() || (atLine1 && atLine2 && diff_unifiedEqualLine(diffs, c, line))) {
+                break;
+            }
+
+            auto&         d(diffs[c.index]);
+            string_view_t rest = d.text.substring(c.offset);
+            if (d.operation == Operation::EQUAL) {
+                size_t p = rest.indexOf(char_traits::eol);
+                if (p == npos) {
+                    c.offset += rest.length();
+                    atLine1 = false;
+                    atLine2 = false;
+                } else {
+                    c.offset += p + 1;
+                    c.line1++;
+                    c.line2++;
+                    atLine1 = true;
+                    atLine2 = true;
+                }
+                continue;
+            }
+
+            size_t lines = 0;
+            for (size_t p = rest.indexOf(char_traits::eol); p != npos; p = rest.indexOf(char_traits::eol, p + 1)) {
+                lines++;
+            }
+            bool atLine = rest.data()[rest.length() - 1] == char_traits::eol;
+            if (d.operation == Operation::DELETE) {
+                c.line1 += lines;
+                atLine1 = atLine;
+            } else {
+                c.line2 += lines;
+                atLine2 = atLine;
+            }
+            c.offset = d.text.length();
+        }
+        // A last line without newline.
+        c.line1 += atLine1 ? 0 : 1;
+        c.line2 += atLine2 ? 0 : 1;
+    }
+
+    /**
+     * Write the lines of one text between the cursors, each after the prefix.
+     */
+private:
+    template <typename Stream>
+    inline static constexpr void diff_unifiedWriteChange(Stream& s, const diffs_t& diffs, const unified_cursor& from, const unified_cursor& to, Operation skip,
+                                                         char prefix) noexcept {
+        using namespace dmp::utils;
+
+        bool atLine = true;
+        for (size_t i = from.index; i < diffs.size() && (i < to.index || (i == to.index && to.offset > 0)); i++) {
+            auto& d(diffs[i]);
+            if (d.operation == skip) {
+                continue;
+            }
+            size_t        offset = i == from.index ? from.offset : 0;
+            string_view_t piece  = d.text.substring(offset, (i == to.index ? to.offset : d.text.length()) - offset);
+            while (!piece.empty()) {
+                if (atLine) {
+                    char_traits::write(s, prefix);
+                }
+                size_t p = piece.indexOf(char_traits::eol);
+                if (p == npos) {
+                    writeToStream(s, piece);
+                    atLine = false;
+                    break;
+                }
+                writeToStream(s, piece.substring(0, p + 1));
+                piece  = piece.substring(p + 1);
+                atLine = true;
+            }
+        }
+        if (!atLine) {
+            char_traits::write(s, "\n\\ No newline at end of file\n");
+        }
+    }
+
+private:
+    template <typename Stream>
+    inline static constexpr void diff_unifiedWriteLine(Stream& s, const string_view_t& line) noexcept {
+        using namespace dmp::utils;
+
+        writeToStream(s, line);
+        if (line.empty() || line.data()[line.length() - 1] != char_traits::eol) {
+            char_traits::write(s, "\n\\ No newline at end of file\n");
+        }
+    }
+
+    /**
+     * Write a hunk range, the first line and the number of lines.  The count
+     * is left out for one line, an empty range starts at the line before.
+     */
+private:
+    template <typename Stream>
+    inline static constexpr void diff_unifiedRange(Stream& s, size_t start, size_t length) noexcept {
+        using namespace dmp::utils;
+
+        writeToStream(s, length == 0 ? start : start + 1);
+        if (length != 1) {
+            char_traits::write(s, ',');
+            writeToStream(s, length);
+        }
+    }
+
 public:
     inline static constexpr bool nextLine(string_view_t& line, const string_view_t& text, size_t& start, size_t length, char_t separator) noexcept {
         if (start >= length) {
@@ -56,8 +56,10 @@ int main(int argc, char **argv) {
 
 #include "dmp/algorithms/dmp_algorithms_common.h"
 #include "dmp/traits/dmp_encoding_sub_traits.h"
+#include "dmp/traits/dmp_executor_traits_none.h"
 #include "dmp/types/dmp_diff.h"
 #include "dmp/types/dmp_settings.h"
+#include "dmp/types/dmp_tokenizer.h"
 #include "dmp/utils/dmp_encoding.h"
 #include "dmp/utils/dmp_stringpool_base.h"
 
@@ -76,6 +78,8 @@ struct diff_match_patch_diff {
     using clock_traits = typename all_traits::clock_traits;
     using clock_t      = typename clock_traits::type;
 
+    using executor_traits = typename all_traits::executor_traits;
+
     using string_traits = typename all_traits::string_traits;
 
     using char_traits     = typename string_traits::char_traits;
@@ -85,16 +89,26 @@ struct diff_match_patch_diff {
 
     static constexpr const size_t npos = string_traits::npos;
 
+    // Texts up to this number of 64 bit words are diffed bit-parallel.
+    static constexpr const size_t diff_bitParallelMaxWords = 4;
+    // The bit-parallel diff keeps a column per char of the longer text, longer
+    // texts are left to diff_bisect which runs in linear space.
+    static constexpr const size_t diff_bitParallelMaxColumns = 1 << 16;
+
 
     using container_traits = typename all_traits::container_traits;
 
     template <typename key, typename value>
     using encoding_hash_t = typename container_traits::template encoding_hash<key, value>;
+    template <typename key, typename value>
+    using line_hash_t = typename container_traits::template line_hash<key, value>;
 
     using string_pool_t = typename commons::string_pool_t;
 
 
     using Operation = typename commons::Operation;
+    using Cleanup   = typename commons::Cleanup;
+    using LineDiff  = typename commons::LineDiff;
     using diff_t    = typename commons::diff_t;
     using diffs_t   = typename commons::diffs_t;
 
@@ -113,6 +127,106 @@ struct diff_match_patch_diff {
     using encoding_diff_t  = typename encoding_algorithm_diff_t::diff_t;
     using encoding_diffs_t = typename encoding_algorithm_diff_t::diffs_t;
 
+    using bisect_list_t = typename container_traits::template bisect_list<int>;
+    // Indexed by line, the line count is bounded by the encoding list.
+    using line_list_t = typename container_traits::template encoding_list<int>;
+
+    /**
+     * Equality on the stack of diff_cleanupSemantic and diff_cleanupEfficiency,
+     * with the edits between it and the equality below it.
+     */
+    struct equality_t {
+        size_t index      = 0;
+        size_t insertions = 0;
+        size_t deletions  = 0;
+    };
+
+    using equalities_list_t = typename container_traits::template equalities_list<equality_t>;
+
+public:
+    struct diff_workspace;
+
+    /**
+     * Range of both texts still to be diffed by diff_anchoredLines, or an
+     * equality to be emitted.
+     */
+    struct anchor_range {
+        int  start1 = 0;
+        int  end1   = 0;
+        int  start2 = 0;
+        int  end2   = 0;
+        bool equal  = false;
+    };
+
+    /**
+     * End of each diff of a diff list in text1 and text2, see
+     * diff_xIndexPrepare.
+     */
+    struct diff_offsets {
+        typename container_traits::template bisect_list<size_t> chars1;
+        typename container_traits::template bisect_list<size_t> chars2;
+    };
+
+    /**
+     * MinHash sketch of the set of q-grams of a text, see diff_makeSketch.
+     */
+    struct diff_sketch {
+        static constexpr size_t buckets = 256;
+        static constexpr size_t qgram   = 4;
+
+        // Smallest hash + 1 of the q-grams falling into each bucket, 0 if
+        // none did.
+        uint64_t minima[buckets] {};
+    };
+
+private:
+    struct no_workspace {};
+    using encoding_workspace_t = std::conditional_t<needsSubEncoder, typename encoding_algorithm_diff_t::diff_workspace, no_workspace>;
+
+public:
+    /**
+     * Scratch buffers of the diff functions.
+     * Passing the same workspace to subsequent calls reuses the buffers,
+     * they only grow and are never shrunk.
+     * A workspace must not be shared by concurrent calls.
+     */
+    struct diff_workspace {
+        // diff_bisect
+        bisect_list_t v1;
+        bisect_list_t v2;
+
+        // Diagonals visited by diff_bisect in the last diff, see Diff_MaxWork.
+        size_t work = 0;
+
+        // diff_bitParallel, there are at most 2 * 64 * diff_bitParallelMaxWords slots.
+        typename container_traits::template bisect_list<uint64_t> bitColumns;
+        typename container_traits::template bisect_list<uint64_t> bitMasks;
+        typename container_traits::template encoding_list<char_t> bitSlotChars;
+        typename container_traits::template encoding_list<size_t> bitSlotMasks;
+
+        // diff_cleanupSemantic, diff_cleanupEfficiency
+        equalities_list_t equalities;
+        bisect_list_t     eliminated;
+
+        // diff_anchoredLines
+        line_list_t                                                     lineCounts1;
+        line_list_t                                                     lineCounts2;
+        line_list_t                                                     linePositions;
+        line_list_t                                                     lineNext;
+        line_list_t                                                     anchors1;
+        line_list_t                                                     anchors2;
+        line_list_t                                                     anchorTails;
+        line_list_t                                                     anchorPrevious;
+        typename container_traits::template encoding_list<anchor_range> anchorRanges;
+
+        // diff_lineMode, diff_tokenMode
+        line_hash_t<string_view_t, encoding_char_t> lineHash;
+        encoding_list_t                             lines;
+        encoding_owning_string_t                    encodedStrings[2] {};
+        encoding_diffs_t                            lineDiffs;
+        encoding_workspace_t                        encoded;
+    };
+
 public:
     constexpr diff_match_patch_diff() noexcept = default;
 
@@ -146,6 +260,38 @@ public:
 public:
     inline static constexpr void diff_main(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, string_view_t text1, string_view_t text2,
                                            bool checklines) noexcept {
+        diff_workspace workspace;
+        diff_main(settings, diffs, pool, workspace, text1, text2, checklines);
+    }
+
+    /**
+     * Find the differences between two texts, reusing the scratch buffers
+     * of the given workspace.
+     * @param workspace Scratch buffers, see diff_workspace.
+     * @param text1 Old string to be diffed.
+     * @param text2 New string to be diffed.
+     * @return List of Diff objects.
+     */
+public:
+    inline static constexpr void diff_main(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, diff_workspace& workspace,
+                                           string_view_t text1, string_view_t text2) noexcept {
+        diff_main(settings, diffs, pool, workspace, text1, text2, true);
+    }
+
+    /**
+     * Find the differences between two texts, reusing the scratch buffers
+     * of the given workspace.
+     * @param workspace Scratch buffers, see diff_workspace.
+     * @param text1 Old string to be diffed.
+     * @param text2 New string to be diffed.
+     * @param checklines Speedup flag.  If false, then don't run a
+     *     line-level diff first to identify the changed areas.
+     *     If true, then run a faster slightly less optimal diff.
+     * @return List of Diff objects.
+     */
+public:
+    inline static constexpr void diff_main(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, diff_workspace& workspace,
+                                           string_view_t text1, string_view_t text2, bool checklines) noexcept {
         // Set a deadline by which time the diff must be complete.
 
         clock_t deadline;
@@ -154,7 +300,8 @@ public:
             deadline.addMilliseconds(static_cast<int64_t>(settings.Diff_Timeout * 1000.f));
         }
 
-        diff_main(settings, diffs, pool, text1, text2, checklines, deadline);
+        workspace.work = 0;
+        diff_main(settings, diffs, pool, workspace, text1, text2, checklines, deadline);
     }
 
 
@@ -174,6 +321,13 @@ public:
 public:
     inline static constexpr void diff_main(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, string_view_t text1, string_view_t text2,
                                            bool checklines, clock_t deadline) noexcept {
+        diff_workspace workspace;
+        diff_main(settings, diffs, pool, workspace, text1, text2, checklines, deadline);
+    }
+
+public:
+    inline static constexpr void diff_main(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, diff_workspace& workspace,
+                                           string_view_t text1, string_view_t text2, bool checklines, clock_t deadline) noexcept {
         // Check for null inputs not needed since null can't be passed in C#.
 
         using namespace dmp::utils;
@@ -204,7 +358,7 @@ public:
         // Restore the prefix.
 
         // Compute the diff on the middle block.
-        diff_compute(settings, diffs, pool, text1, text2, checklines, deadline);
+        diff_compute(settings, diffs, pool, workspace, text1, text2, checklines, deadline);
 
         // Restore the prefix and suffix.
         if (commonprefix.length() != 0) {
@@ -218,6 +372,425 @@ public:
     }
 
 
+    /**
+     * Find the differences between two texts if they are at most maxEdits
+     * edits apart, counting each inserted and each deleted character as one
+     * edit.  The edit distance is decided first by walking only the diagonals
+     * |k| <= maxEdits of the edit graph, in O(maxEdits * n) time and
+     * O(maxEdits) memory.  If it is within the bound, the diffs are the ones
+     * of diff_main.
+     * @param text1 Old string to be diffed.
+     * @param text2 New string to be diffed.
+     * @param maxEdits Maximum number of edits.
+     * @return false if the texts are more than maxEdits edits apart, diffs is
+     *     empty then.
+     */
+public:
+    inline static constexpr bool diff_main_bounded(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, diff_workspace& workspace,
+                                                   string_view_t text1, string_view_t text2, size_t maxEdits) noexcept {
+        diffs.clear();
+
+        // Trim off common prefix and suffix, they don't change the distance.
+        auto          commonlength = commons::diff_commonPrefix(text1, text2);
+        string_view_t middle1      = text1.substring(commonlength);
+        string_view_t middle2      = text2.substring(commonlength);
+        commonlength               = commons::diff_commonSuffix(middle1, middle2);
+        middle1                    = middle1.substring(0, middle1.length() - commonlength);
+        middle2                    = middle2.substring(0, middle2.length() - commonlength);
+
+        if (!diff_withinEdits(workspace, middle1, middle2, maxEdits)) {
+            return false;
+        }
+
+        diff_main(settings, diffs, pool, workspace, text1, text2, true);
+        return true;
+    }
+
+
+    /**
+     * Sketch a text for diff_similarity.  Each q-gram of the text is hashed
+     * once and the smallest hash falling into each bucket is kept (one
+     * permutation MinHash), in a single pass over the text.  Texts shorter
+     * than a q-gram are taken as one q-gram.
+     * @param text String to be sketched.
+     * @return The sketch, to be compared with any number of others.
+     */
+public:
+    inline static constexpr diff_sketch diff_makeSketch(string_view_t text) noexcept {
+        using sketch_char_t = std::make_unsigned_t<char_t>;
+        constexpr uint64_t base = 0x100000001b3ull;
+
+        diff_sketch sketch;
+        size_t      q = text.length() < diff_sketch::qgram ? text.length() : diff_sketch::qgram;
+        if (q == 0) {
+            return sketch;
+        }
+
+        uint64_t power = 1;
+        for (size_t i = 1; i < q; i++) {
+            power *= base;
+        }
+
+        // Polynomial hash of the q-gram ending at i, rolled by one character.
+        auto     d(text.data());
+        uint64_t hash = 0;
+        for (size_t i = 0; i < text.length(); i++) {
+            if (i >= q) {
+                hash -= power * static_cast<sketch_char_t>(d[i - q]);
+            }
+            hash = hash * base + static_cast<sketch_char_t>(d[i]);
+            if (i + 1 >= q) {
+                // Mix the bits before splitting into bucket and value.
+                uint64_t h = hash;
+                h          = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+                h          = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+                h          = h ^ (h >> 31);
+
+                auto& minimum(sketch.minima[h % diff_sketch::buckets]);
+                h = h / diff_sketch::buckets + 1;
+                if (minimum == 0 || h < minimum) {
+                    minimum = h;
+                }
+            }
+        }
+        return sketch;
+    }
+
+    /**
+     * Estimate the similarity of two sketched texts, the Jaccard index of
+     * their q-gram sets: 1 for the same q-grams, 0 for none in common.
+     * The estimate is the share of equal minima among the buckets used by
+     * either text.  Its standard error is about sqrt(J * (1 - J) / m) <=
+     * 0.5 / sqrt(m) for a similarity J and m buckets used, 1/32 for all 256.
+     * @param sketch1 Sketch of the first text, see diff_makeSketch.
+     * @param sketch2 Sketch of the second text.
+     * @return The similarity in [0, 1].
+     */
+public:
+    inline static constexpr float diff_similarity(const diff_sketch& sketch1, const diff_sketch& sketch2) noexcept {
+        size_t used  = 0;
+        size_t equal = 0;
+        for (size_t i = 0; i < diff_sketch::buckets; i++) {
+            if (sketch1.minima[i] != 0 || sketch2.minima[i] != 0) {
+                used++;
+                equal += sketch1.minima[i] == sketch2.minima[i] ? 1u : 0u;
+            }
+        }
+        if (used == 0) {
+            // Both texts are empty.
+            return 1.f;
+        }
+        return static_cast<float>(equal) / static_cast<float>(used);
+    }
+
+    /**
+     * Estimate the similarity of two texts, see diff_similarity of their
+     * sketches.
+     * @param text1 First string.
+     * @param text2 Second string.
+     * @return The similarity in [0, 1].
+     */
+public:
+    inline static constexpr float diff_similarity(string_view_t text1, string_view_t text2) noexcept {
+        return diff_similarity(diff_makeSketch(text1), diff_makeSketch(text2));
+    }
+
+
+    /**
+     * Walk the front path of diff_bisect on the diagonals |k| <= maxEdits
+     * only, until it reaches the end of both texts.
+     * @param text1 Old string.
+     * @param text2 New string.
+     * @param maxEdits Maximum number of edits.
+     * @return true if the texts are at most maxEdits edits apart.
+     */
+private:
+    inline static constexpr bool diff_withinEdits(diff_workspace& workspace, string_view_t text1, string_view_t text2, size_t maxEdits) noexcept {
+        using namespace dmp::utils;
+
+        size_t text1_length = text1.length();
+        size_t text2_length = text2.length();
+        size_t lengthDelta  = text1_length > text2_length ? text1_length - text2_length : text2_length - text1_length;
+        if (lengthDelta > maxEdits) {
+            // Each edit changes the length difference by one at most.
+            return false;
+        }
+        if (text1_length == 0 || text2_length == 0) {
+            return true;
+        }
+
+        int  n = static_cast<int>(text1_length);
+        int  m = static_cast<int>(text2_length);
+        auto d1(text1.data());
+        auto d2(text2.data());
+        int  max_d    = maxEdits < text1_length + text2_length ? static_cast<int>(maxEdits) : n + m;
+        int  v_offset = max_d + 1;
+        int  v_length = 2 * max_d + 3;
+
+        auto& v(workspace.v1);
+        if (v.size() < static_cast<size_t>(v_length)) {
+            v.resize(static_cast<size_t>(v_length));
+        }
+        for (size_t i = 0; i < static_cast<size_t>(v_length); i++) {
+            v[i] = -1;
+        }
+
+        v[static_cast<size_t>(v_offset + 1)] = 0;
+        // Offsets for start and end of k loop.
+        // Prevents mapping of space beyond the grid.
+        int kstart = 0;
+        int kend   = 0;
+        for (int d = 0; d <= max_d; d++) {
+            for (int k = -d + kstart; k <= d - kend; k += 2) {
+                int k_offset = v_offset + k;
+                int x {};
+                if (k == -d || (k != d && v[static_cast<size_t>(k_offset - 1)] < v[static_cast<size_t>(k_offset + 1)])) {
+                    x = v[static_cast<size_t>(k_offset + 1)];
+                } else {
+                    x = v[static_cast<size_t>(k_offset - 1)] + 1;
+                }
+                int y = x - k;
+                if (x < n && y < m) {
+                    // Follow the snake.
+                    int snake = static_cast<int>(commonPrefixLength(d1 + x, d2 + y, static_cast<size_t>(min(n - x, m - y))));
+                    x += snake;
+                    y += snake;
+                }
+                v[static_cast<size_t>(k_offset)] = x;
+                if (x > n) {
+                    // Ran off the right of the graph.
+                    kend += 2;
+                } else if (y > m) {
+                    // Ran off the bottom of the graph.
+                    kstart += 2;
+                } else if (x == n && y == m) {
+                    // Reached the end with d edits.
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+
+    /**
+     * Update the diffs of text1 and text2 after text2 has been edited.
+     * Only the edit is diffed again, together with the diffs of the 64
+     * characters around it, cut inside equalities.  The new diffs are
+     * spliced in and merged with their neighbours.
+     * The diffs are walked up to the edit to find it and after it to move
+     * them onto the edited text2, those before it only if they don't view
+     * text1 and text2 already, e.g. if text2 is a new string.  So the cost
+     * is that of the diff of the edit plus O(number of diffs).
+     * Afterwards all diffs view text1 or text2, none of them a string of
+     * the pool.
+     * The diffs after the edit are only checked against the texts if the
+     * edit is at the end, they must be the diffs of text1 and text2.
+     * @param diffs Diffs of text1 and text2 before the edit, updated in place.
+     * @param text1 Old string, unchanged by the edit.
+     * @param text2 New string, text2 after the edit.
+     * @param offset Position of the edit in text2 before the edit.
+     * @param removedLength Number of characters removed at offset.
+     * @param insertedLength Number of characters inserted at offset.
+     * @return false if the edit doesn't match the diffs.
+     */
+public:
+    inline static constexpr bool diff_rediff(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, diff_workspace& workspace,
+                                             string_view_t text1, string_view_t text2, size_t offset, size_t removedLength,
+                                             size_t insertedLength) noexcept {
+        // Characters around the edit diffed again with it.
+        constexpr size_t context = 64;
+
+        if (offset > text2.length() || insertedLength > text2.length() - offset) {
+            return false;
+        }
+
+        // The region [first, last) of diffs to replace starts in the last
+        // equality starting before the context and ends in the first equality
+        // reaching past it.  Only [start, end) of the region is diffed again.
+        // Without such an equality the region starts or ends with the diffs.
+        size_t editEnd   = offset + removedLength;
+        size_t before    = offset > context ? offset - context : 0;
+        size_t after     = editEnd + context;
+        size_t first     = 0;
+        size_t firstPos1 = 0;
+        size_t firstPos2 = 0;
+        size_t start1    = 0;
+        size_t start2    = 0;
+        size_t last      = diffs.size();
+        size_t lastEnd1  = 0;
+        size_t lastEnd2  = 0;
+        size_t end1      = 0;
+        size_t end2      = 0;
+        size_t pos1      = 0;
+        size_t pos2      = 0;
+        bool   atEnd     = true;
+        bool   moved     = false;
+        for (size_t i = 0; i < diffs.size(); i++) {
+            auto&  d(diffs[i]);
+            size_t length = d.text.length();
+            if (pos2 + length <= offset && !moved) {
+                // Before the edit text2 is the same, the diff may view it.
+                if (d.operation == Operation::INSERT) {
+                    moved = d.text.data() != text2.data() + pos2;
+                } else {
+                    moved = pos1 + length > text1.length() || d.text.data() != text1.data() + pos1;
+                }
+            }
+            if (d.operation == Operation::EQUAL) {
+                if (pos2 < before) {
+                    first     = i;
+                    firstPos1 = pos1;
+                    firstPos2 = pos2;
+                    start2    = pos2 + length < before ? pos2 + length : before;
+                    start1    = pos1 + (start2 - pos2);
+                }
+                if (pos2 + length > after) {
+                    last     = i + 1;
+                    lastEnd1 = pos1 + length;
+                    lastEnd2 = pos2 + length;
+                    end2     = pos2 > after ? pos2 : after;
+                    end1     = pos1 + (end2 - pos2);
+                    atEnd    = false;
+                    break;
+                }
+            }
+            if (d.operation != Operation::INSERT) {
+                pos1 += length;
+            }
+            if (d.operation != Operation::DELETE) {
+                pos2 += length;
+            }
+        }
+        if (atEnd) {
+            // The edit reaches the end, all diffs have been walked.
+            if (editEnd > pos2 || pos1 != text1.length() || text2.length() != pos2 - removedLength + insertedLength) {
+                return false;
+            }
+            lastEnd1 = end1 = pos1;
+            lastEnd2 = end2 = pos2;
+        } else if (lastEnd1 > text1.length() || text2.length() < lastEnd2 - removedLength + insertedLength) {
+            return false;
+        }
+
+        diffs_t subDiffs;
+        diff_main(settings, subDiffs, pool, workspace, text1.substring(start1, end1 - start1),
+                  text2.substring(start2, end2 - removedLength + insertedLength - start2), true);
+
+        // Append a diff of the given length at pos1/pos2 to a list as a view
+        // into text1 or text2, joined with a last diff of the same operation.
+        auto add = [&](diffs_t& list, Operation op, size_t length) {
+            if (length == 0) {
+                return;
+            }
+            if (!list.empty() && list.back().operation == op) {
+                auto&  back(list.back());
+                size_t backLength = back.text.length();
+                back.text         = op == Operation::INSERT ? text2.substring(pos2 - backLength, backLength + length)
+                                                            : text1.substring(pos1 - backLength, backLength + length);
+            } else {
+                list.push_back(diff_t(op, op == Operation::INSERT ? text2.substring(pos2, length) : text1.substring(pos1, length)));
+            }
+            if (op != Operation::INSERT) {
+                pos1 += length;
+            }
+            if (op != Operation::DELETE) {
+                pos2 += length;
+            }
+        };
+
+        // Rebuild the region from the kept parts of the equalities and the
+        // new diffs.
+        diffs_t region;
+        pos1 = firstPos1;
+        pos2 = firstPos2;
+        add(region, Operation::EQUAL, start1 - firstPos1);
+        for (auto& d : subDiffs) {
+            add(region, d.operation, d.text.length());
+        }
+        add(region, Operation::EQUAL, lastEnd2 - end2);
+
+        diffs.splice(first, last - first, region);
+
+        // Merge the region with a neighbour on each side, widened to start
+        // and end with equalities.  Merging may shift an edit across such an
+        // equality, then the range is widened and merged again.  The merged
+        // diffs are moved onto text1 and text2, which also joins diffs
+        // diff_cleanupMerge leaves next to each other, e.g. the equality it
+        // factors out of the edits at the start.
+        size_t from  = first;
+        size_t to    = first + region.size();
+        size_t from1 = firstPos1;
+        size_t from2 = firstPos2;
+        auto   widen = [&]() {
+            auto& d(diffs[--from]);
+            if (d.operation != Operation::INSERT) {
+                from1 -= d.text.length();
+            }
+            if (d.operation != Operation::DELETE) {
+                from2 -= d.text.length();
+            }
+        };
+        while (true) {
+            if (from > 0) {
+                widen();
+            }
+            while (from > 0 && diffs[from].operation != Operation::EQUAL) {
+                widen();
+            }
+            if (to < diffs.size()) {
+                to++;
+            }
+            while (to < diffs.size() && diffs[to - 1].operation != Operation::EQUAL) {
+                to++;
+            }
+
+            diffs_t merged;
+            for (size_t i = from; i < to; i++) {
+                merged.push_back(diffs[i]);
+            }
+            diff_cleanupMerge(merged, pool);
+
+            diffs_t joined;
+            pos1 = from1;
+            pos2 = from2;
+            for (auto& d : merged) {
+                add(joined, d.operation, d.text.length());
+            }
+            diffs.splice(from, to - from, joined);
+            to = from + joined.size();
+
+            if ((from == 0 || (to > from && diffs[from].operation == Operation::EQUAL))
+                && (to == diffs.size() || (to > from && diffs[to - 1].operation == Operation::EQUAL))) {
+                break;
+            }
+        }
+
+        // Move the other diffs onto text1 and the edited text2, the old text2
+        // may be gone and diffs may still view strings of the pool.
+        auto rebase = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                auto&  d(diffs[i]);
+                size_t length = d.text.length();
+                d.text        = d.operation == Operation::INSERT ? text2.substring(pos2, length) : text1.substring(pos1, length);
+                if (d.operation != Operation::INSERT) {
+                    pos1 += length;
+                }
+                if (d.operation != Operation::DELETE) {
+                    pos2 += length;
+                }
+            }
+        };
+        rebase(to, diffs.size());
+        if (moved) {
+            pos1 = 0;
+            pos2 = 0;
+            rebase(0, from);
+        }
+        return true;
+    }
+
+
 protected:
     struct HalfMatchResult {
         string_view_t best_longtext_a;
@@ -298,8 +871,8 @@ protected:
      * @return List of Diff objects.
      */
 private:
-    inline static constexpr void diff_compute(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, string_view_t text1,
-                                              string_view_t text2, bool checklines, clock_t deadline) noexcept {
+    inline static constexpr void diff_compute(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, diff_workspace& workspace,
+                                              string_view_t text1, string_view_t text2, bool checklines, clock_t deadline) noexcept {
         using namespace dmp::utils;
 
 
@@ -336,29 +909,178 @@ private:
         }
 
 
+        // Check to see if the shorter text is small enough for the bit-parallel diff (speedup).
+        if (diff_bitParallel(diffs, workspace, text1, text2, deadline)) {
+            return;
+        }
+
+        // Check to see if huge texts can be split at unique lines (speedup).
+        if (checklines && settings.Diff_AnchorThreshold > 0 && text1.length() + text2.length() >= static_cast<size_t>(settings.Diff_AnchorThreshold)
+            && diff_anchored(settings, diffs, pool, workspace, text1, text2, deadline)) {
+            return;
+        }
+
         // Check to see if the problem can be split in two.
         HalfMatchResult hm;
         if (diff_halfMatch(settings, hm, text1, text2)) {
             // A half-match was found, sort out the return data.
             // Send both pairs off for separate processing.
             // Merge the results.
-            diff_main(settings, diffs, pool, hm.best_longtext_a, hm.best_shorttext_a, checklines, deadline);
-            diffs.push_back(diff_t(Operation::EQUAL, hm.best_common));
             diffs_t diffs_b;
-            diff_main(settings, diffs_b, pool, hm.best_longtext_b, hm.best_shorttext_b, checklines, deadline);
+            diff_mainPair(settings, pool, workspace, diffs, hm.best_longtext_a, hm.best_shorttext_a, diffs_b, hm.best_longtext_b,
+                          hm.best_shorttext_b, checklines, deadline);
+            diffs.push_back(diff_t(Operation::EQUAL, hm.best_common));
             diffs.addAll(diffs_b);
             return;
         }
 
 
         if (checklines && text1.length() > 100 && text2.length() > 100) {
-            diff_lineMode(settings, diffs, pool, text1, text2, deadline);
+            diff_lineMode(settings, diffs, pool, workspace, text1, text2, deadline);
             return;
         }
 
-        diff_bisect(settings, diffs, pool, text1, text2, deadline);
+        diff_bisect(settings, diffs, pool, workspace, text1, text2, deadline);
+    }
+
+
+    /**
+     * Split both texts at the longest increasing sequence of lines which
+     * occur exactly once in both texts, then diff the segments between these
+     * anchors separately.
+     * This speedup can produce non-minimal diffs.
+     * @param text1 Old string to be diffed.
+     * @param text2 New string to be diffed.
+     * @param deadline Time when the diff should be complete by.
+     * @return False if there are no such lines, diffs is untouched then.
+     */
+private:
+    inline static constexpr bool diff_anchored(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, diff_workspace& workspace,
+                                               string_view_t text1, string_view_t text2, clock_t deadline) noexcept {
+        using namespace dmp::utils;
+
+        auto& lines(workspace.lines);
+        diff_linesToChars(workspace.encodedStrings, text1, text2, lines, workspace.lineHash);
+
+        encoding_string_view_t s1 { workspace.encodedStrings[0] };
+        encoding_string_view_t s2 { workspace.encodedStrings[1] };
+
+        auto& eworkspace(diff_encodingWorkspace(workspace));
+        if (lines.size() > eworkspace.lineCounts1.max_size() || max(s1.length(), s2.length()) > eworkspace.anchors1.max_size()) {
+            // Doesn't fit into the lists.
+            return false;
+        }
+        eworkspace.lineCounts1.resize(max(eworkspace.lineCounts1.size(), lines.size()), 0);
+        eworkspace.lineCounts2.resize(max(eworkspace.lineCounts2.size(), lines.size()), 0);
+        eworkspace.linePositions.resize(max(eworkspace.linePositions.size(), lines.size()), 0);
+
+        using erange_t = typename encoding_algorithm_diff_t::anchor_range;
+        erange_t erange { 0, static_cast<int>(s1.length()), 0, static_cast<int>(s2.length()), false };
+        if (!encoding_algorithm_diff_t::diff_uniqueAnchors(eworkspace, s1, s2, erange)) {
+            return false;
+        }
+
+        // The anchor sequence is linked back to front.
+        bisect_list_t chain;
+        for (int n = eworkspace.anchorTails.back(); n != -1; n = eworkspace.anchorPrevious[static_cast<size_t>(n)]) {
+            chain.push_back(n);
+        }
+
+        typename container_traits::template bisect_list<anchor_range> segments;
+        if (2 * chain.size() + 1 > segments.max_size()) {
+            return false;
+        }
+
+        // Turn the line indices into character positions, the segments
+        // alternate between ranges to diff and the anchor lines.
+        int  line1     = 0;
+        int  line2     = 0;
+        int  position1 = 0;
+        int  position2 = 0;
+        auto advance   = [&lines](encoding_string_view_t s, int& line, int& position, int to) {
+            for (; line < to; line++) {
+                position += static_cast<int>(lines[static_cast<size_t>(s.data()[line])].length());
+            }
+        };
+        for (size_t k = chain.size(); k-- > 0;) {
+            auto n(static_cast<size_t>(chain[k]));
+            int  start1 = position1;
+            int  start2 = position2;
+            advance(s1, line1, position1, eworkspace.anchors1[n]);
+            advance(s2, line2, position2, eworkspace.anchors2[n]);
+            if (position1 != start1 || position2 != start2) {
+                segments.push_back(anchor_range { start1, position1, start2, position2, false });
+            }
+            start1 = position1;
+            start2 = position2;
+            advance(s1, line1, position1, line1 + 1);
+            advance(s2, line2, position2, line2 + 1);
+            if (!segments.empty() && segments.back().equal && segments.back().end1 == start1) {
+                // Join subsequent anchor lines.
+                segments.back().end1 = position1;
+                segments.back().end2 = position2;
+            } else {
+                segments.push_back(anchor_range { start1, position1, start2, position2, true });
+            }
+        }
+        int text1_length = static_cast<int>(text1.length());
+        int text2_length = static_cast<int>(text2.length());
+        if (position1 != text1_length || position2 != text2_length) {
+            segments.push_back(anchor_range { position1, text1_length, position2, text2_length, false });
+        }
+
+        // diff_main merges the diffs of the segments.
+        diff_segments(settings, diffs, pool, workspace, text1, text2, segments, 0, segments.size(), deadline);
+        return true;
     }
 
+    /**
+     * Diff the segments [first, last) found by diff_anchored and append the
+     * diffs.  With a parallel executor_traits both halves of the segments are
+     * diffed in parallel.
+     * @param segments Ranges to diff or equal anchor lines.
+     */
+private:
+    template <typename segments_t>
+    inline static constexpr void diff_segments(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, diff_workspace& workspace,
+                                               string_view_t text1, string_view_t text2, const segments_t& segments, size_t first, size_t last,
+                                               clock_t deadline) noexcept {
+        auto part1 = [&text1](int start, int end) { return text1.substring(static_cast<size_t>(start), static_cast<size_t>(end - start)); };
+        auto part2 = [&text2](int start, int end) { return text2.substring(static_cast<size_t>(start), static_cast<size_t>(end - start)); };
+
+        if (last - first == 1) {
+            auto& segment(segments[first]);
+            if (segment.equal) {
+                diffs.push_back(diff_t(Operation::EQUAL, part1(segment.start1, segment.end1)));
+            } else {
+                diffs_t subDiffs;
+                diff_main(settings, subDiffs, pool, workspace, part1(segment.start1, segment.end1), part2(segment.start2, segment.end2), true,
+                          deadline);
+                diffs.addAll(subDiffs);
+            }
+            return;
+        }
+
+        size_t middle = first + (last - first) / 2;
+        if constexpr (executor_traits::parallel) {
+            int threshold = settings.Diff_ParallelThreshold;
+            if (threshold > 0 && settings.Diff_MaxWork <= 0 && segments[middle - 1].end1 - segments[first].start1 >= threshold
+                && segments[last - 1].end1 - segments[middle].start1 >= threshold) {
+                string_pool_t  pool_b(pool.textsData.texts, pool.textsData.num);
+                diff_workspace workspace_b;
+                diffs_t        diffs_b;
+                executor_traits::invoke(
+                    [&]() { diff_segments(settings, diffs, pool, workspace, text1, text2, segments, first, middle, deadline); },
+                    [&]() { diff_segments(settings, diffs_b, pool_b, workspace_b, text1, text2, segments, middle, last, deadline); });
+                pool.adopt(pool_b);
+                diffs.addAll(diffs_b);
+                return;
+            }
+        }
+
+        diff_segments(settings, diffs, pool, workspace, text1, text2, segments, first, middle, deadline);
+        diff_segments(settings, diffs, pool, workspace, text1, text2, segments, middle, last, deadline);
+    }
 
     /**
      * Do a quick line-level diff on both strings, then rediff the parts for
@@ -370,16 +1092,15 @@ private:
      * @return List of Diff objects.
      */
 private:
-    inline static constexpr void diff_lineMode(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, string_view_t text1,
-                                               string_view_t text2, clock_t deadline) noexcept {
+    inline static constexpr void diff_lineMode(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, diff_workspace& workspace,
+                                               string_view_t text1, string_view_t text2, clock_t deadline) noexcept {
         using namespace dmp::utils;
 
-        encoding_owning_string_t encodedStrings[2] {};
-
-        encoding_list_t linearray;
+        auto& encodedStrings(workspace.encodedStrings);
+        auto& linearray(workspace.lines);
 
         // Scan the text on a line-by-line basis first.
-        diff_linesToChars(encodedStrings, text1, text2, linearray);
+        diff_linesToChars(encodedStrings, text1, text2, linearray, workspace.lineHash);
 
         encoding_string_view_t s1 { encodedStrings[0] };
         encoding_string_view_t s2 { encodedStrings[1] };
@@ -389,13 +1110,14 @@ private:
         eoriginal_texts_t      otexts[] { &s1, &s2 };
         encoding_string_pool_t stringpool(otexts);
 
-        encoding_diffs_t eDiffs;
-        encoding_algorithm_diff_t::diff_main(settings, eDiffs, stringpool, s1, s2, false, deadline);
+        auto& eDiffs(workspace.lineDiffs);
+        eDiffs.clear();
+        diff_encoded(settings, eDiffs, stringpool, workspace, s1, s2, linearray.size(), deadline);
 
         // Convert the diff back to original text.
         diff_charsToLines(diffs, pool, eDiffs, linearray);
         // Eliminate freak matches (e.g. blank lines)
-        diff_cleanupSemantic(diffs, pool);
+        diff_cleanupSemantic(diffs, pool, workspace);
 
         // Rediff any replacement blocks, this time character-by-character.
         // Add a dummy entry at the end.
@@ -420,7 +1142,7 @@ private:
                     if (count_delete >= 1 && count_insert >= 1) {
                         // Delete the offending records and add the merged ones.
                         diffs_t subDiffs;
-                        diff_main(settings, subDiffs, pool, text_delete, text_insert, false, deadline);
+                        diff_main(settings, subDiffs, pool, workspace, text_delete, text_insert, false, deadline);
 
                         diffs.splice(pointer - count_delete - count_insert, count_delete + count_insert, subDiffs);
                         pointer = pointer - count_delete - count_insert;
@@ -438,61 +1160,457 @@ private:
     }
 
     /**
-     * Split two texts into a list of strings.  Reduce the texts to a string of
-     * hashes where each Unicode character represents one line.
-     * @param text1 First string.
-     * @param text2 Second string.
-     * @return Three element Object array, containing the encoded text1, the
-     *     encoded text2 and the List of unique strings.  The zeroth element
-     *     of the List of unique strings is intentionally blank.
+     * Find the differences between two token encoded texts, tokens are
+     * lines or any other parts of the texts.  Uses the algorithm set by
+     * Diff_LineAlgorithm.
+     * @param text1 Old token encoded string.
+     * @param text2 New token encoded string.
+     * @param alphabet Number of token indices, all characters are below.
+     * @param deadline Time when the diff should be complete by.
      */
-protected:
-    inline static constexpr void diff_linesToChars(encoding_owning_string_t (&encodedStrings)[2], string_view_t text1, string_view_t text2,
-                                                   encoding_list_t& lines) noexcept {
-        using namespace dmp::utils;
-
-        encodedStrings[0] = encoding_owning_string_t {};
-        encodedStrings[1] = encoding_owning_string_t {};
+private:
+    inline static constexpr void diff_encoded(const settings_t& settings, encoding_diffs_t& eDiffs, encoding_string_pool_t& pool,
+                                              diff_workspace& workspace, encoding_string_view_t text1, encoding_string_view_t text2, size_t alphabet,
+                                              clock_t deadline) noexcept {
+        // The work of the encoded diff counts towards Diff_MaxWork as well.
+        auto& eworkspace(diff_encodingWorkspace(workspace));
+        eworkspace.work = workspace.work;
+
+        if (settings.Diff_LineAlgorithm == LineDiff::MYERS) {
+            encoding_algorithm_diff_t::diff_main(settings, eDiffs, pool, eworkspace, text1, text2, false, deadline);
+        } else {
+            encoding_algorithm_diff_t::diff_anchoredLines(settings, eDiffs, pool, eworkspace, text1, text2, alphabet,
+                                                          settings.Diff_LineAlgorithm == LineDiff::HISTOGRAM, deadline);
+        }
 
-        encoding_hash_t<string_view_t, encoding_char_t> lineHash;
-        // e.g. linearray[4] == "Hello\n"
-        // e.g. linehash.get("Hello\n") == 4
+        workspace.work = eworkspace.work;
+    }
 
-        // "\x00" is a valid character, but various debuggers don't like it.
-        // So we'll insert a junk entry to avoid generating a null character.
-        // lines.push_back(string_view_t {});
+    /**
+     * Find the differences between two texts token by token.  The texts are
+     * split into tokens by the tokenizer, e.g. words, and the tokens are
+     * diffed like the lines in line mode.  There is no character-level
+     * refinement, every diff consists of whole tokens and views into text1
+     * or text2, nothing is copied.
+     * @param text1 Old string to be diffed.
+     * @param text2 New string to be diffed.
+     * @param tokenizer Tokenizer policy, see dmp_tokenizer.h.
+     * @return List of Diff objects.
+     */
+public:
+    template <typename tokenizer_t>
+    inline static constexpr void diff_tokenMode(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, diff_workspace& workspace,
+                                                string_view_t text1, string_view_t text2, const tokenizer_t& tokenizer) noexcept {
+        clock_t deadline;
+        if (settings.Diff_Timeout > 0) {
+            deadline = clock_t::now();
+            deadline.addMilliseconds(static_cast<int64_t>(settings.Diff_Timeout * 1000.f));
+        }
+
+        workspace.work = 0;
+        diff_tokenMode(settings, diffs, pool, workspace, text1, text2, tokenizer, deadline);
+    }
+
+public:
+    template <typename tokenizer_t>
+    inline static constexpr void diff_tokenMode(const settings_t& settings, diffs_t& diffs, string_pool_t& /*pool*/, diff_workspace& workspace,
+                                                string_view_t text1, string_view_t text2, const tokenizer_t& tokenizer, clock_t deadline) noexcept {
+        diffs.clear();
+
+        auto& encodedStrings(workspace.encodedStrings);
+        auto& tokens(workspace.lines);
+
+        diff_tokensToChars(encodedStrings, text1, text2, tokens, workspace.lineHash, tokenizer);
+
+        encoding_string_view_t s1 { encodedStrings[0] };
+        encoding_string_view_t s2 { encodedStrings[1] };
+
+
+        using eoriginal_texts_t = typename encoding_string_pool_t::original_texts;
+        eoriginal_texts_t      otexts[] { &s1, &s2 };
+        encoding_string_pool_t stringpool(otexts);
+
+        auto& eDiffs(workspace.lineDiffs);
+        eDiffs.clear();
+        diff_encoded(settings, eDiffs, stringpool, workspace, s1, s2, tokens.size(), deadline);
+
+        diff_charsToTokens(diffs, eDiffs, tokens, text1, text2);
+    }
+
+    /**
+     * Workspace of the diff on the line encoded texts, which is the given
+     * workspace itself if no sub encoder is needed.
+     */
+private:
+    inline static constexpr auto& diff_encodingWorkspace(diff_workspace& workspace) noexcept {
+        if constexpr (needsSubEncoder) {
+            return workspace.encoded;
+        } else {
+            return workspace;
+        }
+    }
+
+    /**
+     * Find the differences between two line encoded texts by patience or
+     * histogram diff.  Lines unique in both texts or the least frequent
+     * lines are aligned first and split the texts into smaller ranges.
+     * Ranges without any such lines are diffed by diff_main.
+     * @param text1 Old line encoded string, each character is a line index.
+     * @param text2 New line encoded string.
+     * @param alphabet Number of line indices, all characters are below.
+     * @param histogram True for histogram diff, false for patience diff.
+     * @param deadline Time when the diff should be complete by.
+     */
+public:
+    inline static constexpr void diff_anchoredLines(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, diff_workspace& workspace,
+                                                    string_view_t text1, string_view_t text2, size_t alphabet, bool histogram,
+                                                    clock_t deadline) noexcept {
+        using namespace dmp::utils;
+
+        int  text1_length = static_cast<int>(text1.length());
+        int  text2_length = static_cast<int>(text2.length());
+        auto d1(text1.data());
+        auto d2(text2.data());
+        auto part1 = [&text1](int start, int end) { return text1.substring(static_cast<size_t>(start), static_cast<size_t>(end - start)); };
+        auto part2 = [&text2](int start, int end) { return text2.substring(static_cast<size_t>(start), static_cast<size_t>(end - start)); };
+
+        auto& ranges(workspace.anchorRanges);
+        if (alphabet > workspace.lineCounts1.max_size() || static_cast<size_t>(max(text1_length, text2_length)) > workspace.anchors1.max_size()) {
+            // Doesn't fit into the lists.
+            diff_main(settings, diffs, pool, workspace, text1, text2, false, deadline);
+            return;
+        }
+
+        // The counts are kept zero between the ranges.
+        workspace.lineCounts1.resize(max(workspace.lineCounts1.size(), alphabet), 0);
+        workspace.lineCounts2.resize(max(workspace.lineCounts2.size(), alphabet), 0);
+        workspace.linePositions.resize(max(workspace.linePositions.size(), alphabet), 0);
+        workspace.lineNext.resize(max(workspace.lineNext.size(), static_cast<size_t>(text1_length)), 0);
+
+        // The ranges are a stack, the front most range is on top.
+        ranges.clear();
+        ranges.push_back(anchor_range { 0, text1_length, 0, text2_length, false });
+        while (!ranges.empty()) {
+            anchor_range range(ranges.back());
+            ranges.pop_back();
+
+            if (range.equal) {
+                diffs.push_back(diff_t(Operation::EQUAL, part1(range.start1, range.end1)));
+                continue;
+            }
+
+            // Trim off common prefix and suffix.
+            int length = min(range.end1 - range.start1, range.end2 - range.start2);
+            int prefix = static_cast<int>(commonPrefixLength(d1 + range.start1, d2 + range.start2, static_cast<size_t>(length)));
+            if (prefix != 0) {
+                diffs.push_back(diff_t(Operation::EQUAL, part1(range.start1, range.start1 + prefix)));
+                range.start1 += prefix;
+                range.start2 += prefix;
+            }
+            int suffix = static_cast<int>(commonSuffixLength(d1 + range.end1, d2 + range.end2, static_cast<size_t>(length - prefix)));
+            if (suffix != 0) {
+                ranges.push_back(anchor_range { range.end1 - suffix, range.end1, range.end2 - suffix, range.end2, true });
+                range.end1 -= suffix;
+                range.end2 -= suffix;
+            }
+
+            if (range.start1 == range.end1 || range.start2 == range.end2) {
+                if (range.start1 != range.end1) {
+                    diffs.push_back(diff_t(Operation::DELETE, part1(range.start1, range.end1)));
+                }
+                if (range.start2 != range.end2) {
+                    diffs.push_back(diff_t(Operation::INSERT, part2(range.start2, range.end2)));
+                }
+                continue;
+            }
+
+            if (histogram ? !diff_histogramSplit(workspace, text1, text2, range) : !diff_patienceSplit(workspace, text1, text2, range)) {
+                // Nothing to align, diff the range as a whole.
+                diffs_t subDiffs;
+                diff_main(settings, subDiffs, pool, workspace, part1(range.start1, range.end1), part2(range.start2, range.end2), false, deadline);
+                diffs.addAll(subDiffs);
+            }
+        }
+
+        diff_cleanupMerge(diffs, pool);
+    }
+
+    /**
+     * Split a range at the longest increasing sequence of lines which occur
+     * exactly once in both texts, pushing the parts onto the range stack.
+     * @param range Range without common prefix and suffix.
+     * @return False if there is no such line.
+     */
+private:
+    inline static constexpr bool diff_patienceSplit(diff_workspace& workspace, string_view_t text1, string_view_t text2,
+                                                    const anchor_range& range) noexcept {
+        auto& anchors1(workspace.anchors1);
+        auto& anchors2(workspace.anchors2);
+        auto& tails(workspace.anchorTails);
+        auto& previous(workspace.anchorPrevious);
+        auto& ranges(workspace.anchorRanges);
+
+        if (!diff_uniqueAnchors(workspace, text1, text2, range) || ranges.size() + 2 * anchors1.size() + 1 > ranges.max_size()) {
+            return false;
+        }
+
+        // Push the ranges between the anchors back to front.
+        int end1 = range.end1;
+        int end2 = range.end2;
+        for (int n = tails.back(); n != -1; n = previous[static_cast<size_t>(n)]) {
+            int anchor1 = anchors1[static_cast<size_t>(n)];
+            int anchor2 = anchors2[static_cast<size_t>(n)];
+            ranges.push_back(anchor_range { anchor1 + 1, end1, anchor2 + 1, end2, false });
+            ranges.push_back(anchor_range { anchor1, anchor1 + 1, anchor2, anchor2 + 1, true });
+            end1 = anchor1;
+            end2 = anchor2;
+        }
+        ranges.push_back(anchor_range { range.start1, end1, range.start2, end2, false });
+        return true;
+    }
+
+    /**
+     * Find the longest increasing sequence of characters which occur exactly
+     * once in both ranges, e.g. of lines unique in both line encoded texts.
+     * The character counts of the workspace must be sized for all characters
+     * and zero.  The sequence ends with anchorTails.back() and is linked from
+     * back to front by anchorPrevious, the positions of the n-th unique
+     * character are anchors1[n] and anchors2[n].
+     * @param range Range of both texts to search.
+     * @return False if there is no such character.
+     */
+public:
+    inline static constexpr bool diff_uniqueAnchors(diff_workspace& workspace, string_view_t text1, string_view_t text2,
+                                                    const anchor_range& range) noexcept {
+        auto  d1(text1.data());
+        auto  d2(text2.data());
+        auto& counts1(workspace.lineCounts1);
+        auto& counts2(workspace.lineCounts2);
+        auto& positions(workspace.linePositions);
+        auto& anchors1(workspace.anchors1);
+        auto& anchors2(workspace.anchors2);
+        auto& tails(workspace.anchorTails);
+        auto& previous(workspace.anchorPrevious);
+
+        for (int i = range.start1; i < range.end1; i++) {
+            counts1[static_cast<size_t>(d1[i])]++;
+        }
+        for (int j = range.start2; j < range.end2; j++) {
+            counts2[static_cast<size_t>(d2[j])]++;
+            positions[static_cast<size_t>(d2[j])] = j;
+        }
+
+        // Unique lines in the order of text1.
+        anchors1.clear();
+        anchors2.clear();
+        for (int i = range.start1; i < range.end1; i++) {
+            auto c(static_cast<size_t>(d1[i]));
+            if (counts1[c] == 1 && counts2[c] == 1) {
+                anchors1.push_back(i);
+                anchors2.push_back(positions[c]);
+            }
+        }
+
+        for (int i = range.start1; i < range.end1; i++) {
+            counts1[static_cast<size_t>(d1[i])] = 0;
+        }
+        for (int j = range.start2; j < range.end2; j++) {
+            counts2[static_cast<size_t>(d2[j])] = 0;
+        }
+
+        size_t anchors = anchors1.size();
+        if (anchors == 0) {
+            return false;
+        }
+
+        // Longest increasing sequence of the text2 positions by patience
+        // sorting, tails[k] ends the best sequence of length k + 1.
+        tails.clear();
+        previous.resize(anchors);
+        for (size_t n = 0; n < anchors; n++) {
+            size_t low  = 0;
+            size_t high = tails.size();
+            while (low < high) {
+                size_t mid = (low + high) / 2;
+                if (anchors2[static_cast<size_t>(tails[mid])] < anchors2[n]) {
+                    low = mid + 1;
+                } else {
+                    high = mid;
+                }
+            }
+            previous[n] = low == 0 ? -1 : tails[low - 1];
+            if (low == tails.size()) {
+                tails.push_back(static_cast<int>(n));
+            } else {
+                tails[low] = static_cast<int>(n);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Split a range around the longest common run of lines containing the
+     * least frequent line of text1, pushing the parts onto the range stack.
+     * Like git, lines occurring more than 64 times in text1 are ignored.
+     * @param range Range without common prefix and suffix.
+     * @return False if there is no common line.
+     */
+private:
+    inline static constexpr bool diff_histogramSplit(diff_workspace& workspace, string_view_t text1, string_view_t text2,
+                                                     const anchor_range& range) noexcept {
+        using namespace dmp::utils;
+
+        constexpr const int maxChain = 64;
+
+        auto  d1(text1.data());
+        auto  d2(text2.data());
+        auto& counts(workspace.lineCounts1);
+        auto& heads(workspace.linePositions);
+        auto& next(workspace.lineNext);
+        auto& ranges(workspace.anchorRanges);
+
+        // Chain the occurrences of each line of text1 front to back.
+        for (int i = range.end1 - 1; i >= range.start1; i--) {
+            auto c(static_cast<size_t>(d1[i]));
+            next[static_cast<size_t>(i)] = counts[c]++ == 0 ? -1 : heads[c];
+            heads[c]                     = i;
+        }
+
+        int best_count  = maxChain;
+        int best_start1 = 0;
+        int best_start2 = 0;
+        int best_length = 0;
+        for (int j = range.start2; j < range.end2;) {
+            int next_j = j + 1;
+            int count  = counts[static_cast<size_t>(d2[j])];
+            if (count != 0 && count <= best_count) {
+                for (int i = heads[static_cast<size_t>(d2[j])]; i != -1; i = next[static_cast<size_t>(i)]) {
+                    // Extend the match in both directions.
+                    int start1 = i;
+                    int start2 = j;
+                    int end1   = i + 1;
+                    int end2   = j + 1;
+                    int lowest = count;
+                    while (start1 > range.start1 && start2 > range.start2 && d1[start1 - 1] == d2[start2 - 1]) {
+                        start1--;
+                        start2--;
+                        lowest = min(lowest, counts[static_cast<size_t>(d1[start1])]);
+                    }
+                    while (end1 < range.end1 && end2 < range.end2 && d1[end1] == d2[end2]) {
+                        lowest = min(lowest, counts[static_cast<size_t>(d1[end1])]);
+                        end1++;
+                        end2++;
+                    }
+                    next_j = max(next_j, end2);
+
+                    if (end1 - start1 > best_length || lowest < best_count) {
+                        best_count  = lowest;
+                        best_start1 = start1;
+                        best_start2 = start2;
+                        best_length = end1 - start1;
+                    }
+                }
+            }
+            j = next_j;
+        }
+
+        for (int i = range.start1; i < range.end1; i++) {
+            counts[static_cast<size_t>(d1[i])] = 0;
+        }
+
+        if (best_length == 0 || ranges.size() + 3 > ranges.max_size()) {
+            return false;
+        }
+
+        ranges.push_back(anchor_range { best_start1 + best_length, range.end1, best_start2 + best_length, range.end2, false });
+        ranges.push_back(anchor_range { best_start1, best_start1 + best_length, best_start2, best_start2 + best_length, true });
+        ranges.push_back(anchor_range { range.start1, best_start1, range.start2, best_start2, false });
+        return true;
+    }
+
+    /**
+     * Split two texts into a list of strings.  Reduce the texts to a string of
+     * hashes where each Unicode character represents one line.
+     * @param text1 First string.
+     * @param text2 Second string.
+     * @return Three element Object array, containing the encoded text1, the
+     *     encoded text2 and the List of unique strings.  The zeroth element
+     *     of the List of unique strings is intentionally blank.
+     */
+protected:
+    inline static constexpr void diff_linesToChars(encoding_owning_string_t (&encodedStrings)[2], string_view_t text1, string_view_t text2,
+                                                   encoding_list_t& lines) noexcept {
+        line_hash_t<string_view_t, encoding_char_t> lineHash;
+        diff_linesToChars(encodedStrings, text1, text2, lines, lineHash);
+    }
+
+protected:
+    inline static constexpr void diff_linesToChars(encoding_owning_string_t (&encodedStrings)[2], string_view_t text1, string_view_t text2,
+                                                   encoding_list_t& lines, line_hash_t<string_view_t, encoding_char_t>& lineHash) noexcept {
+        diff_tokensToChars(encodedStrings, text1, text2, lines, lineHash, types::line_tokenizer {});
+    }
+
+    /**
+     * Split two texts into tokens.  Reduce the texts to a string of hashes
+     * where each character represents one token.
+     * @param text1 First string.
+     * @param text2 Second string.
+     * @param tokens List of unique tokens, the zeroth element is blank.
+     * @param tokenHash Map of tokens to indices.
+     * @param tokenizer Tokenizer policy, see dmp_tokenizer.h.
+     */
+protected:
+    template <typename tokenizer_t>
+    inline static constexpr void diff_tokensToChars(encoding_owning_string_t (&encodedStrings)[2], string_view_t text1, string_view_t text2,
+                                                    encoding_list_t& lines, line_hash_t<string_view_t, encoding_char_t>& lineHash,
+                                                    const tokenizer_t& tokenizer) noexcept {
+        using namespace dmp::utils;
+
+        encodedStrings[0].clear();
+        encodedStrings[1].clear();
+
+        lineHash.clear();
+        // e.g. linearray[4] == "Hello\n"
+        // e.g. linehash.get("Hello\n") == 4
+
+        // "\x00" is a valid character, but various debuggers don't like it.
+        // So we'll insert a junk entry to avoid generating a null character.
+        // lines.push_back(string_view_t {});
 
         // Allocate 2/3rds of the space for text1, the rest for text2.
-        diff_linesToCharsMunge(encodedStrings[0], text1, lineHash, 40000);
-        diff_linesToCharsMunge(encodedStrings[1], text2, lineHash, 65535);
+        // Index 0 is left out, so the list holds one line more than the maximum.
+        size_t maxLines = min(static_cast<size_t>((std::numeric_limits<encoding_char_t>::max)()), lines.max_size() - 1);
+        diff_tokensToCharsMunge(encodedStrings[0], text1, lineHash, maxLines / 3 * 2, tokenizer);
+        diff_tokensToCharsMunge(encodedStrings[1], text2, lineHash, maxLines, tokenizer);
 
 
+        lines.clear();
         lines.resize(lineHash.size() + 1);
         for (auto& p : lineHash) {
-            lines[p.second] = p.first;
+            lines[static_cast<size_t>(p.second)] = p.first;
         }
     }
 
     /**
-     * Split a text into a list of strings.  Reduce the texts to a string of
-     * hashes where each Unicode character represents one line.
+     * Split a text into a list of tokens.  Reduce the texts to a string of
+     * hashes where each Unicode character represents one token.
      * @param text String to encode.
-     * @param lineArray List of unique strings.
-     * @param lineHash Map of strings to indices.
-     * @param maxLines Maximum length of lineArray.
+     * @param tokenHash Map of tokens to indices.
+     * @param maxTokens Maximum length of the token list.
+     * @param tokenizer Tokenizer policy, see dmp_tokenizer.h.
      * @return Encoded string.
      */
 private:
-    inline static constexpr void diff_linesToCharsMunge(encoding_owning_string_t& encoded_string, string_view_t text,
-                                                        encoding_hash_t<string_view_t, encoding_char_t>& lineHash,
-                                                        encoding_char_t                                  maxLines) noexcept {
+    template <typename tokenizer_t>
+    inline static constexpr void diff_tokensToCharsMunge(encoding_owning_string_t& encoded_string, string_view_t text,
+                                                         line_hash_t<string_view_t, encoding_char_t>& tokenHash, size_t maxTokens,
+                                                         const tokenizer_t& tokenizer) noexcept {
         using namespace dmp::utils;
 
-        size_t        lineStart = 0;
-        size_t        lineEnd   = 0;
-        string_view_t line {};
+        size_t tokenStart = 0;
+        size_t tokenEnd   = 0;
 
-        // Walk the text, pulling out a substring for each line.
+        // Walk the text, pulling out a substring for each token.
         // text.split(eol) would would temporarily double our memory footprint.
         // Modifying text would create many large strings to garbage collect.
         auto len(text.length());
@@ -503,23 +1621,60 @@ private:
         encoded_string.reserve(64);
 
         do {
-            lineEnd = text.indexOf(char_traits::eol, lineStart);
-            if (lineEnd == npos) {
-                lineEnd = len - 1;
+            encoding_char_t id(static_cast<encoding_char_t>(tokenHash.size() + 1));
+            if (tokenHash.size() + 1 == maxTokens) {
+                // Bail out at maxTokens, the encoding char or the token list
+                // can't hold any more.  The rest of the text is one token.
+                tokenEnd = len;
+            } else {
+                tokenEnd = tokenizer(text, tokenStart);
+                if (tokenEnd <= tokenStart || tokenEnd > len) {
+                    // Guard against tokenizers which would stall the walk.
+                    tokenEnd = len;
+                }
             }
-            line = text.substring(lineStart, lineEnd + 1 - lineStart);
 
-            encoding_char_t id(static_cast<encoding_char_t>(lineHash.size() + 1));
-            if (id == maxLines) {
-                // Bail out at 65535 because char 65536 == char 0.
-                line    = text.substring(lineStart);
-                lineEnd = text.length();
+            // Token indices need up to 32 bits.
+            encoded_string.push_back(tokenHash.insertAndReturnValue(text.substring(tokenStart, tokenEnd - tokenStart), id));
+            tokenStart = tokenEnd;
+        } while (tokenEnd < len);
+    }
+
+    /**
+     * Rehydrate the text in a diff from a string of token hashes to views
+     * into the original texts.  The tokens partition both texts, so the
+     * tokens of each diff follow each other in text1 or text2.
+     * @param diffs List of Diff objects.
+     * @param eDiffs List of token encoded Diff objects.
+     * @param tokens List of unique tokens.
+     * @param text1 Old string which was diffed.
+     * @param text2 New string which was diffed.
+     */
+protected:
+    inline static constexpr void diff_charsToTokens(diffs_t& diffs, const encoding_diffs_t& eDiffs, const encoding_list_t& tokens,
+                                                    string_view_t text1, string_view_t text2) noexcept {
+        diffs.reserve(diffs.size() + eDiffs.size());
+
+        size_t pointer1 = 0;
+        size_t pointer2 = 0;
+        for (auto& ed : eDiffs) {
+            size_t length = 0;
+            for (auto& c : ed.text) {
+                length += tokens[static_cast<size_t>(c)].length();
             }
 
-            // we might need more than 256 chars here, so use at least a short
-            encoded_string.push_back(lineHash.insertAndReturnValue(line, id));
-            lineStart = lineEnd + 1;
-        } while (lineEnd < len - 1);
+            auto operation(static_cast<Operation>(ed.operation));
+            if (operation == Operation::INSERT) {
+                diffs.push_back(diff_t(operation, text2.substring(pointer2, length)));
+                pointer2 += length;
+            } else {
+                diffs.push_back(diff_t(operation, text1.substring(pointer1, length)));
+                pointer1 += length;
+                if (operation == Operation::EQUAL) {
+                    pointer2 += length;
+                }
+            }
+        }
     }
 
     /**
@@ -536,10 +1691,29 @@ protected:
         diffs.reserve(diffs.size() + eDiffs.size());
 
         for (auto& ed : eDiffs) {
+            // Lines which follow each other in the text are just joined,
+            // otherwise all lines are copied once into a new string.
             string_view_t text;
-
+            size_t        length     = 0;
+            bool          contiguous = true;
             for (auto& c : ed.text) {
-                pool.append(text, lines[static_cast<size_t>(c)]);
+                auto& line(lines[static_cast<size_t>(c)]);
+                if (length == 0) {
+                    text = line;
+                } else if (contiguous && text.data() + length == line.data()) {
+                    text = string_view_t { text.data(), length + line.length() };
+                } else {
+                    contiguous = false;
+                }
+                length += line.length();
+            }
+
+            if (!contiguous) {
+                text = pool.createFilled(length, [&ed, &lines](auto*& p, size_t& l) {
+                    for (auto& c : ed.text) {
+                        str_copy(p, l, lines[static_cast<size_t>(c)]);
+                    }
+                });
             }
 
             diffs.push_back(diff_t(static_cast<Operation>(ed.operation), text));
@@ -547,7 +1721,8 @@ protected:
     }
 
 protected:
-    inline static constexpr bool diff_bisect(string_view_t text1, string_view_t text2, clock_t deadline, int& _x1, int& _y1) noexcept {
+    inline static constexpr bool diff_bisect(const settings_t& settings, diff_workspace& workspace, string_view_t text1, string_view_t text2,
+                                             clock_t deadline, int& _x1, int& _y1) noexcept {
         using namespace dmp::utils;
 
         // Cache the text lengths to prevent multiple calls.
@@ -559,9 +1734,16 @@ protected:
         int  v_offset = max_d;
         int  v_length = 2 * max_d;
 
-        using List = typename container_traits::template bisect_list<int>;
-        List v1(static_cast<size_t>(v_length), -1);
-        List v2(static_cast<size_t>(v_length), -1);
+        auto& v1(workspace.v1);
+        auto& v2(workspace.v2);
+        if (v1.size() < static_cast<size_t>(v_length)) {
+            v1.resize(static_cast<size_t>(v_length));
+            v2.resize(static_cast<size_t>(v_length));
+        }
+        for (size_t i = 0; i < static_cast<size_t>(v_length); i++) {
+            v1[i] = -1;
+            v2[i] = -1;
+        }
 
         v1[static_cast<size_t>(v_offset + 1)] = 0;
         v2[static_cast<size_t>(v_offset + 1)] = 0;
@@ -575,14 +1757,18 @@ protected:
         int k1end   = 0;
         int k2start = 0;
         int k2end   = 0;
+        // Diagonals visited, see Diff_MaxWork.
+        size_t work    = workspace.work;
+        size_t maxWork = settings.Diff_MaxWork > 0 ? static_cast<size_t>(settings.Diff_MaxWork) : 0;
         for (int d = 0; d < max_d; d++) {
-            // Bail out if deadline is reached.
-            if (deadline.hitDeadline()) {
+            // Bail out if deadline or the work limit is reached.
+            if (deadline.hitDeadline() || (maxWork > 0 && work >= maxWork)) {
                 break;
             }
 
             // Walk the front path one step.
             for (int k1 = -d + k1start; k1 <= d - k1end; k1 += 2) {
+                work++;
                 int k1_offset = v_offset + k1;
                 int x1 {};
                 // @fix: parentheses
@@ -592,9 +1778,11 @@ protected:
                     x1 = v1[static_cast<size_t>(k1_offset - 1)] + 1;
                 }
                 int y1 = x1 - k1;
-                while (x1 < text1_length && y1 < text2_length && d1[x1] == d2[y1]) {
-                    x1++;
-                    y1++;
+                if (x1 < text1_length && y1 < text2_length) {
+                    // Follow the snake.
+                    int snake = static_cast<int>(commonPrefixLength(d1 + x1, d2 + y1, static_cast<size_t>(min(text1_length - x1, text2_length - y1))));
+                    x1 += snake;
+                    y1 += snake;
                 }
                 v1[static_cast<size_t>(k1_offset)] = x1;
                 if (x1 > text1_length) {
@@ -611,8 +1799,9 @@ protected:
                         if (x1 >= x2) {
                             // Overlap detected.
 
-                            _x1 = x1;
-                            _y1 = y1;
+                            _x1            = x1;
+                            _y1            = y1;
+                            workspace.work = work;
                             return true;
                         }
                     }
@@ -621,6 +1810,7 @@ protected:
 
             // Walk the reverse path one step.
             for (int k2 = -d + k2start; k2 <= d - k2end; k2 += 2) {
+                work++;
                 int k2_offset = v_offset + k2;
                 int x2 {};
                 // @fix: parentheses
@@ -630,9 +1820,12 @@ protected:
                     x2 = v2[static_cast<size_t>(k2_offset - 1)] + 1;
                 }
                 int y2 = x2 - k2;
-                while (x2 < text1_length && y2 < text2_length && d1[text1_length - x2 - 1] == d2[text2_length - y2 - 1]) {
-                    x2++;
-                    y2++;
+                if (x2 < text1_length && y2 < text2_length) {
+                    // Follow the snake backwards.
+                    int snake = static_cast<int>(commonSuffixLength(d1 + (text1_length - x2), d2 + (text2_length - y2),
+                                                                    static_cast<size_t>(min(text1_length - x2, text2_length - y2))));
+                    x2 += snake;
+                    y2 += snake;
                 }
                 v2[static_cast<size_t>(k2_offset)] = x2;
                 if (x2 > text1_length) {
@@ -650,8 +1843,9 @@ protected:
                         if (x1 >= x2) {
                             // Overlap detected.
 
-                            _x1 = x1;
-                            _y1 = v_offset + x1 - k1_offset;
+                            _x1            = x1;
+                            _y1            = v_offset + x1 - k1_offset;
+                            workspace.work = work;
                             return true;
                         }
                     }
@@ -659,18 +1853,246 @@ protected:
             }
         }
 
+        workspace.work = work;
         return false;
     }
 
+    /**
+     * Variant of diff_bisect that walks the front path on the calling thread
+     * and the reverse path on an idle worker.  Both meet at a barrier after
+     * each step d.  Overlaps are checked in the same order as by diff_bisect,
+     * so the same middle snake is found.  Without an idle worker or a second
+     * hardware thread this is diff_bisect.
+     */
+protected:
+    inline static constexpr bool diff_bisectConcurrent(const settings_t& settings, diff_workspace& workspace, string_view_t text1,
+                                                       string_view_t text2, clock_t deadline, int& _x1, int& _y1) noexcept {
+        using namespace dmp::utils;
+
+        if constexpr (!executor_traits::parallel) {
+            return diff_bisect(settings, workspace, text1, text2, deadline, _x1, _y1);
+        } else {
+            // Cache the text lengths to prevent multiple calls.
+            int  text1_length = static_cast<int>(text1.length());
+            int  text2_length = static_cast<int>(text2.length());
+            auto d1(text1.data());
+            auto d2(text2.data());
+            int  max_d    = (text1_length + text2_length + 1) / 2;
+            int  v_offset = max_d;
+            int  v_length = 2 * max_d;
+
+            auto& v1(workspace.v1);
+            auto& v2(workspace.v2);
+            if (v1.size() < static_cast<size_t>(v_length)) {
+                v1.resize(static_cast<size_t>(v_length));
+                v2.resize(static_cast<size_t>(v_length));
+            }
+            for (size_t i = 0; i < static_cast<size_t>(v_length); i++) {
+                v1[i] = -1;
+                v2[i] = -1;
+            }
+
+            v1[static_cast<size_t>(v_offset + 1)] = 0;
+            v2[static_cast<size_t>(v_offset + 1)] = 0;
+            int delta        = text1_length - text2_length;
+            // If the total number of characters is odd, then the front path will
+            // collide with the reverse path.
+            bool front = (delta % 2 != 0);
+
+            // Step d of one path only writes the diagonals of d's parity, the
+            // overlap checks of the other path only read the other parity.  So
+            // the reverse path checks step d - 1 while walking step d, and
+            // both stop after the barrier of the step one of them ended.
+            // The end flags alternate by step, a path can't be one step ahead
+            // while the other one still reads them.
+            typename executor_traits::barrier barrier(2);
+            bool                              front_end[2]   = { false, false };
+            bool                              reverse_end[2] = { false, false };
+            bool                              front_found    = false;
+            bool                              reverse_found  = false;
+            size_t                            front_work     = 0;
+            size_t                            reverse_work   = 0;
+            int                               front_x1 {};
+            int                               front_y1 {};
+            int                               reverse_x1 {};
+            int                               reverse_y1 {};
+            auto                              stop = [&](int d) {
+                barrier.arrive_and_wait();
+                return front_end[d & 1] || reverse_end[d & 1];
+            };
+
+            auto walkFront = [&]() {
+                // Offsets for start and end of k loop.
+                // Prevents mapping of space beyond the grid.
+                int k1start = 0;
+                int k1end   = 0;
+                for (int d = 0;; d++) {
+                    // Bail out if deadline is reached.
+                    if (d == max_d || deadline.hitDeadline()) {
+                        front_end[d & 1] = true;
+                    } else {
+                        // Walk the front path one step.
+                        for (int k1 = -d + k1start; k1 <= d - k1end; k1 += 2) {
+                            front_work++;
+                            int k1_offset = v_offset + k1;
+                            int x1 {};
+                            if (k1 == -d || (k1 != d && v1[static_cast<size_t>(k1_offset - 1)] < v1[static_cast<size_t>(k1_offset + 1)])) {
+                                x1 = v1[static_cast<size_t>(k1_offset + 1)];
+                            } else {
+                                x1 = v1[static_cast<size_t>(k1_offset - 1)] + 1;
+                            }
+                            int y1 = x1 - k1;
+                            if (x1 < text1_length && y1 < text2_length) {
+                                // Follow the snake.
+                                int snake = static_cast<int>(
+                                    commonPrefixLength(d1 + x1, d2 + y1, static_cast<size_t>(min(text1_length - x1, text2_length - y1))));
+                                x1 += snake;
+                                y1 += snake;
+                            }
+                            v1[static_cast<size_t>(k1_offset)] = x1;
+                            if (x1 > text1_length) {
+                                // Ran off the right of the graph.
+                                k1end += 2;
+                            } else if (y1 > text2_length) {
+                                // Ran off the bottom of the graph.
+                                k1start += 2;
+                            } else if (front) {
+                                int k2_offset = v_offset + delta - k1;
+                                if (k2_offset >= 0 && k2_offset < v_length && v2[static_cast<size_t>(k2_offset)] != -1) {
+                                    // Mirror x2 onto top-left coordinate system.
+                                    int x2 = text1_length - v2[static_cast<size_t>(k2_offset)];
+                                    if (x1 >= x2) {
+                                        // Overlap detected.
+                                        front_found = true;
+                                        front_x1    = x1;
+                                        front_y1    = y1;
+                                        front_end[d & 1] = true;
+                                        break;
+                                    }
+                                }
+                            }
+                        }
+                    }
+
+                    if (stop(d)) {
+                        return;
+                    }
+                }
+            };
+
+            auto walkReverse = [&]() {
+                int k2start = 0;
+                int k2end   = 0;
+                // Diagonals walked by the previous step.
+                int k2first = 0;
+                int k2last  = -2;
+                for (int d = 0;; d++) {
+                    if (!front) {
+                        // Check the previous step, the front path has finished it.
+                        for (int k2 = k2first; k2 <= k2last; k2 += 2) {
+                            int k2_offset = v_offset + k2;
+                            int x2        = v2[static_cast<size_t>(k2_offset)];
+                            if (x2 > text1_length || x2 - k2 > text2_length) {
+                                // Ran off the graph.
+                                continue;
+                            }
+                            int k1_offset = v_offset + delta - k2;
+                            if (k1_offset >= 0 && k1_offset < v_length && v1[static_cast<size_t>(k1_offset)] != -1) {
+                                int x1 = v1[static_cast<size_t>(k1_offset)];
+                                // Mirror x2 onto top-left coordinate system.
+                                if (x1 >= text1_length - x2) {
+                                    // Overlap detected.
+                                    reverse_found = true;
+                                    reverse_x1    = x1;
+                                    reverse_y1    = v_offset + x1 - k1_offset;
+                                    reverse_end[d & 1] = true;
+                                    break;
+                                }
+                            }
+                        }
+                    }
+
+                    if (d == max_d) {
+                        reverse_end[d & 1] = true;
+                    } else if (!reverse_found) {
+                        // Walk the reverse path one step.
+                        k2first = -d + k2start;
+                        k2last  = k2first - 2;
+                        for (int k2 = k2first; k2 <= d - k2end; k2 += 2) {
+                            reverse_work++;
+                            int k2_offset = v_offset + k2;
+                            int x2 {};
+                            if (k2 == -d || (k2 != d && v2[static_cast<size_t>(k2_offset - 1)] < v2[static_cast<size_t>(k2_offset + 1)])) {
+                                x2 = v2[static_cast<size_t>(k2_offset + 1)];
+                            } else {
+                                x2 = v2[static_cast<size_t>(k2_offset - 1)] + 1;
+                            }
+                            int y2 = x2 - k2;
+                            if (x2 < text1_length && y2 < text2_length) {
+                                // Follow the snake backwards.
+                                int snake = static_cast<int>(commonSuffixLength(d1 + (text1_length - x2), d2 + (text2_length - y2),
+                                                                                static_cast<size_t>(min(text1_length - x2, text2_length - y2))));
+                                x2 += snake;
+                                y2 += snake;
+                            }
+                            v2[static_cast<size_t>(k2_offset)] = x2;
+                            k2last                             = k2;
+                            if (x2 > text1_length) {
+                                // Ran off the left of the graph.
+                                k2end += 2;
+                            } else if (y2 > text2_length) {
+                                // Ran off the top of the graph.
+                                k2start += 2;
+                            }
+                        }
+                    }
+
+                    if (stop(d)) {
+                        return;
+                    }
+                }
+            };
+
+            if (!executor_traits::concurrent(walkFront, walkReverse)) {
+                return diff_bisect(settings, workspace, text1, text2, deadline, _x1, _y1);
+            }
+            workspace.work += front_work + reverse_work;
+
+            // The reverse path found its overlap one step earlier.
+            if (reverse_found) {
+                _x1 = reverse_x1;
+                _y1 = reverse_y1;
+                return true;
+            }
+            if (front_found) {
+                _x1 = front_x1;
+                _y1 = front_y1;
+                return true;
+            }
+            return false;
+        }
+    }
+
     inline static constexpr void diff_bisect(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, string_view_t text1,
                                              string_view_t text2, clock_t deadline) noexcept {
+        diff_workspace workspace;
+        diff_bisect(settings, diffs, pool, workspace, text1, text2, deadline);
+    }
+
+    inline static constexpr void diff_bisect(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, diff_workspace& workspace,
+                                             string_view_t text1, string_view_t text2, clock_t deadline) noexcept {
         using namespace dmp::utils;
 
+        // Walk both paths on two threads if the texts are large enough.
+        bool concurrent = executor_traits::parallel && settings.Diff_ParallelBisectThreshold > 0 && settings.Diff_MaxWork <= 0
+                          && text1.length() + text2.length() >= static_cast<size_t>(settings.Diff_ParallelBisectThreshold);
+
         int x1 {};
         int y1 {};
-        if (diff_bisect(text1, text2, deadline, x1, y1)) {
+        if (concurrent ? diff_bisectConcurrent(settings, workspace, text1, text2, deadline, x1, y1)
+                       : diff_bisect(settings, workspace, text1, text2, deadline, x1, y1)) {
             // this separation into a separate function reduces required stack size
-            diff_bisectSplit(settings, diffs, pool, text1, text2, static_cast<size_t>(x1), static_cast<size_t>(y1), deadline);
+            diff_bisectSplit(settings, diffs, pool, workspace, text1, text2, static_cast<size_t>(x1), static_cast<size_t>(y1), deadline);
             return;
         }
 
@@ -693,20 +2115,209 @@ protected:
      * @return LinkedList of Diff objects.
      */
 private:
-    inline static constexpr void diff_bisectSplit(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, string_view_t text1,
-                                                  string_view_t text2, size_t x, size_t y, clock_t deadline) noexcept {
+    inline static constexpr void diff_bisectSplit(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, diff_workspace& workspace,
+                                                  string_view_t text1, string_view_t text2, size_t x, size_t y, clock_t deadline) noexcept {
         string_view_t text1a = text1.substring(0, x);
         string_view_t text2a = text2.substring(0, y);
         string_view_t text1b = text1.substring(x);
         string_view_t text2b = text2.substring(y);
 
-        // Compute both diffs serially.
-        diff_main(settings, diffs, pool, text1a, text2a, false, deadline);
+        // Compute both diffs serially, or in parallel if they are large enough.
         diffs_t diffs_b;
-        diff_main(settings, diffs_b, pool, text1b, text2b, false, deadline);
+        diff_mainPair(settings, pool, workspace, diffs, text1a, text2a, diffs_b, text1b, text2b, false, deadline);
         diffs.addAll(diffs_b);
     }
 
+    /**
+     * Find the differences of two independent pairs of texts.
+     * Both pairs are diffed in parallel by the executor_traits if both are
+     * at least Diff_ParallelThreshold long, the second one then uses its own
+     * string pool and workspace.  The result doesn't depend on that.
+     * @param diffs_a Result for text1a and text2a.
+     * @param diffs_b Result for text1b and text2b.
+     */
+private:
+    inline static constexpr void diff_mainPair(const settings_t& settings, string_pool_t& pool, diff_workspace& workspace, diffs_t& diffs_a,
+                                               string_view_t text1a, string_view_t text2a, diffs_t& diffs_b, string_view_t text1b,
+                                               string_view_t text2b, bool checklines, clock_t deadline) noexcept {
+        if constexpr (executor_traits::parallel) {
+            size_t threshold = static_cast<size_t>(settings.Diff_ParallelThreshold);
+            if (settings.Diff_ParallelThreshold > 0 && settings.Diff_MaxWork <= 0 && text1a.length() >= threshold && text2a.length() >= threshold
+                && text1b.length() >= threshold && text2b.length() >= threshold) {
+                string_pool_t  pool_b(pool.textsData.texts, pool.textsData.num);
+                diff_workspace workspace_b;
+                executor_traits::invoke([&]() { diff_main(settings, diffs_a, pool, workspace, text1a, text2a, checklines, deadline); },
+                                        [&]() { diff_main(settings, diffs_b, pool_b, workspace_b, text1b, text2b, checklines, deadline); });
+                pool.adopt(pool_b);
+                return;
+            }
+        }
+
+        diff_main(settings, diffs_a, pool, workspace, text1a, text2a, checklines, deadline);
+        diff_main(settings, diffs_b, pool, workspace, text1b, text2b, checklines, deadline);
+    }
+
+
+    /**
+     * Find the differences between two texts with a bit-parallel LCS
+     * (Allison-Dix/Hyyrö), which advances a whole 64 bit word of the shorter
+     * text per character of the longer text.
+     * The result is a minimal diff, equalities are matched as early as possible.
+     * @param workspace Scratch buffers, see diff_workspace.
+     * @param text1 Old string to be diffed.
+     * @param text2 New string to be diffed.
+     * @param deadline Time at which to bail if not yet complete.
+     * @return false if the shorter text doesn't fit into
+     *     diff_bitParallelMaxWords words, the longer text has more than
+     *     diff_bitParallelMaxColumns chars or the deadline is hit, diffs is
+     *     untouched then.
+     */
+protected:
+    inline static constexpr bool diff_bitParallel(diffs_t& diffs, diff_workspace& workspace, string_view_t text1, string_view_t text2,
+                                                  clock_t deadline) noexcept {
+        using namespace dmp::utils;
+
+        // The rows of the bit matrix are the chars of the shorter text.
+        bool          shortIsText1 = text1.length() <= text2.length();
+        string_view_t shorttext    = shortIsText1 ? text1 : text2;
+        string_view_t longtext     = shortIsText1 ? text2 : text1;
+        auto          sd(shorttext.data());
+        auto          ld(longtext.data());
+        size_t        m     = shorttext.length();
+        size_t        n     = longtext.length();
+        size_t        words = (m + 63) / 64;
+        if (m == 0 || words > diff_bitParallelMaxWords || n > diff_bitParallelMaxColumns) {
+            return false;
+        }
+
+        // One column of bits is kept for every char of the longer text for the traceback.
+        auto& columns(workspace.bitColumns);
+        if (n > columns.max_size() / words) {
+            return false;
+        }
+        if (columns.size() < n * words) {
+            columns.resize(n * words);
+        }
+
+        // Open addressing table of the distinct chars of the shorter text,
+        // mask 0 matches nothing.
+        size_t slotBits = 2;
+        while ((static_cast<size_t>(1) << slotBits) < 2 * m) {
+            slotBits++;
+        }
+        size_t slotMask = (static_cast<size_t>(1) << slotBits) - 1;
+        auto&  slotChars(workspace.bitSlotChars);
+        auto&  slotMasks(workspace.bitSlotMasks);
+        auto&  masks(workspace.bitMasks);
+        if (slotMask >= slotMasks.max_size() || (m + 1) * words > masks.max_size()) {
+            return false;
+        }
+        slotChars.resize(slotMask + 1);
+        slotMasks.clear();
+        slotMasks.resize(slotMask + 1, 0);
+        masks.clear();
+        masks.resize(words, 0);
+
+        auto findSlot = [&](char_t c) {
+            size_t slot = (static_cast<uint64_t>(c) * 0x9E3779B97F4A7C15u) >> (64 - slotBits);
+            while (slotMasks[slot] != 0 && slotChars[slot] != c) {
+                slot = (slot + 1) & slotMask;
+            }
+            return slot;
+        };
+
+        // Both texts are processed back to front, so that the traceback can run
+        // front to back and prefers early equalities like diff_bisect does.
+        for (size_t r = 0; r < m; r++) {
+            char_t c    = sd[m - 1 - r];
+            size_t slot = findSlot(c);
+            if (slotMasks[slot] == 0) {
+                slotChars[slot] = c;
+                slotMasks[slot] = masks.size();
+                masks.resize(masks.size() + words, 0);
+            }
+            masks[slotMasks[slot] + r / 64] |= static_cast<uint64_t>(1) << (r % 64);
+        }
+
+        // Bit r of a column is cleared if char m - 1 - r of the shorter text
+        // extends the LCS of the suffixes.
+        uint64_t v[diff_bitParallelMaxWords] {};
+        for (size_t w = 0; w < words; w++) {
+            v[w] = ~static_cast<uint64_t>(0);
+        }
+        for (size_t k = 0; k < n; k++) {
+            // Bail out if deadline is reached, diff_bisect splits the texts then.
+            if (deadline.hitDeadline()) {
+                return false;
+            }
+            size_t   mask  = slotMasks[findSlot(ld[n - 1 - k])];
+            uint64_t carry = 0;
+            for (size_t w = 0; w < words; w++) {
+                // V' = (V + U) | (V - U) with U = V & Peq, carried over the words.
+                uint64_t u        = v[w] & masks[mask + w];
+                uint64_t sum      = v[w] + u;
+                uint64_t overflow = sum < u ? 1 : 0;
+                sum += carry;
+                carry                  = overflow | (sum < carry ? 1 : 0);
+                v[w]                   = sum | (v[w] & ~u);
+                columns[k * words + w] = v[w];
+            }
+        }
+
+        Operation shortOp = shortIsText1 ? Operation::DELETE : Operation::INSERT;
+        Operation longOp  = shortIsText1 ? Operation::INSERT : Operation::DELETE;
+
+        size_t    i     = 0;
+        size_t    j     = 0;
+        size_t    runI  = 0;
+        size_t    runJ  = 0;
+        Operation runOp = Operation::EQUAL;
+
+        auto emitRun = [&]() {
+            if (runOp == shortOp) {
+                diffs.push_back(diff_t(runOp, shorttext.substring(runI, i - runI)));
+            } else if (runOp == longOp) {
+                diffs.push_back(diff_t(runOp, longtext.substring(runJ, j - runJ)));
+            } else if (i != runI) {
+                diffs.push_back(diff_t(runOp, shortIsText1 ? shorttext.substring(runI, i - runI) : longtext.substring(runJ, j - runJ)));
+            }
+        };
+        auto switchRun = [&](Operation op) {
+            if (op != runOp) {
+                if (i != runI || j != runJ) {
+                    emitRun();
+                }
+                runOp = op;
+                runI  = i;
+                runJ  = j;
+            }
+        };
+
+        while (i < m && j < n) {
+            if (sd[i] == ld[j]) {
+                switchRun(Operation::EQUAL);
+                i++;
+                j++;
+            } else if ((columns[(n - 1 - j) * words + (m - 1 - i) / 64] >> ((m - 1 - i) % 64)) & 1) {
+                // Skipping this char of the shorter text keeps the LCS.
+                switchRun(shortOp);
+                i++;
+            } else {
+                switchRun(longOp);
+                j++;
+            }
+        }
+        if (i < m) {
+            switchRun(shortOp);
+            i = m;
+        }
+        if (j < n) {
+            switchRun(longOp);
+            j = n;
+        }
+        emitRun();
+        return true;
+    }
 
     /**
      * Do the two texts share a substring which is at least half the length of
@@ -768,6 +2379,30 @@ protected:
         }
     }
 
+    /**
+     * Run several cleanups in the order diff_cleanupMerge,
+     * diff_cleanupSemantic or diff_cleanupSemanticLossless, and
+     * diff_cleanupEfficiency, sharing the buffers of the workspace.
+     * The result is the same as calling them one after the other.
+     * @param diffs List of Diff objects.
+     * @param cleanups The cleanups to run.
+     */
+public:
+    inline static constexpr void diff_cleanup(const settings_t& settings, diffs_t& diffs, string_pool_t& pool, diff_workspace& workspace,
+                                              Cleanup cleanups) noexcept {
+        if ((cleanups & Cleanup::MERGE) != Cleanup::NONE) {
+            diff_cleanupMerge(diffs, pool);
+        }
+        if ((cleanups & Cleanup::SEMANTIC) != Cleanup::NONE) {
+            diff_cleanupSemantic(diffs, pool, workspace.equalities, workspace.eliminated);
+        } else if ((cleanups & Cleanup::SEMANTIC_LOSSLESS) != Cleanup::NONE) {
+            diff_cleanupSemanticLossless(diffs, pool);
+        }
+        if ((cleanups & Cleanup::EFFICIENCY) != Cleanup::NONE) {
+            diff_cleanupEfficiency(settings, diffs, pool, workspace.equalities, workspace.eliminated);
+        }
+    }
+
     /**
      * Reduce the number of edits by eliminating semantically trivial
      * equalities.
@@ -775,6 +2410,19 @@ protected:
      */
 public:
     inline static constexpr void diff_cleanupSemantic(diffs_t& diffs, string_pool_t& pool) noexcept {
+        equalities_list_t equalities;
+        bisect_list_t     eliminated;
+        diff_cleanupSemantic(diffs, pool, equalities, eliminated);
+    }
+
+public:
+    inline static constexpr void diff_cleanupSemantic(diffs_t& diffs, string_pool_t& pool, diff_workspace& workspace) noexcept {
+        diff_cleanupSemantic(diffs, pool, workspace.equalities, workspace.eliminated);
+    }
+
+protected:
+    inline static constexpr void diff_cleanupSemantic(diffs_t& diffs, string_pool_t& pool, equalities_list_t& equalities,
+                                                      bisect_list_t& eliminated) noexcept {
         if (diffs.size() <= 0) {
             return;
         }
@@ -782,63 +2430,60 @@ public:
         using namespace dmp::utils;
 
         bool changes = false;
-        // Stack of indices where equalities are found.
-        using List = typename container_traits::template equalities_list<int>;
-        List equalities;
+        // Stack of equalities which are not eliminated (yet).
+        equalities.clear();
         equalities.reserve(64);
-        // Always equal to equalities[equalitiesLength-1][1]
-        string_view_t lastEquality {};
-        int           pointer = 0;  // Index of current position.
+        // Equalities are only marked here and split into edits once at the end.
+        eliminated.clear();
+        eliminated.resize(diffs.size(), 0);
+        // Always equal to the length of equalities.back(), 0 if there is none.
+        size_t lastEquality_length = 0;
         // Number of characters that changed prior to the equality.
         size_t length_insertions1 = 0;
         size_t length_deletions1  = 0;
         // Number of characters that changed after the equality.
         size_t length_insertions2 = 0;
         size_t length_deletions2  = 0;
-        while (static_cast<size_t>(pointer) < diffs.size()) {
-            if (diffs[static_cast<size_t>(pointer)].operation == Operation::EQUAL) {  // Equality found.
-                equalities.push_back(pointer);
-                length_insertions1 = length_insertions2;
-                length_deletions1  = length_deletions2;
-                length_insertions2 = 0;
-                length_deletions2  = 0;
-                lastEquality       = diffs[static_cast<size_t>(pointer)].text;
+        for (size_t pointer = 0; pointer < diffs.size(); pointer++) {
+            if (diffs[pointer].operation == Operation::EQUAL) {  // Equality found.
+                equalities.push_back(equality_t {pointer, length_insertions2, length_deletions2});
+                length_insertions1  = length_insertions2;
+                length_deletions1   = length_deletions2;
+                length_insertions2  = 0;
+                length_deletions2   = 0;
+                lastEquality_length = diffs[pointer].text.length();
             } else {  // an insertion or deletion
-                if (diffs[static_cast<size_t>(pointer)].operation == Operation::INSERT) {
-                    length_insertions2 += diffs[static_cast<size_t>(pointer)].text.length();
+                if (diffs[pointer].operation == Operation::INSERT) {
+                    length_insertions2 += diffs[pointer].text.length();
                 } else {
-                    length_deletions2 += diffs[static_cast<size_t>(pointer)].text.length();
+                    length_deletions2 += diffs[pointer].text.length();
                 }
                 // Eliminate an equality that is smaller or equal to the edits on both
-                // sides of it.
-                if (lastEquality.length() > 0 && (lastEquality.length() <= max(length_insertions1, length_deletions1))
-                    && (lastEquality.length() <= max(length_insertions2, length_deletions2))) {
-                    // Duplicate record.
-                    diffs.splice(static_cast<size_t>(equalities.back()), 0, diff_t(Operation::DELETE, lastEquality));
-                    // Change second copy to insert.
-                    diffs[static_cast<size_t>(equalities.back() + 1)].operation = Operation::INSERT;
-                    // Throw away the equality we just deleted.
+                // sides of it.  The equality before it becomes the last one again,
+                // with the eliminated one counting as an insertion and a deletion.
+                while (lastEquality_length > 0 && (lastEquality_length <= max(length_insertions1, length_deletions1))
+                       && (lastEquality_length <= max(length_insertions2, length_deletions2))) {
+                    equality_t equality(equalities.back());
                     equalities.pop_back();
+                    eliminated[equality.index] = 1;
+                    length_insertions2 += equality.insertions + lastEquality_length;
+                    length_deletions2 += equality.deletions + lastEquality_length;
                     if (equalities.size() > 0) {
-                        equalities.pop_back();
+                        length_insertions1  = equalities.back().insertions;
+                        length_deletions1   = equalities.back().deletions;
+                        lastEquality_length = diffs[equalities.back().index].text.length();
+                    } else {
+                        lastEquality_length = 0;
                     }
-                    pointer            = equalities.size() > 0 ? equalities.back() : -1;
-                    length_insertions1 = 0;  // Reset the counters.
-                    length_deletions1  = 0;
-                    length_insertions2 = 0;
-                    length_deletions2  = 0;
-                    lastEquality       = string_view_t {};
-                    changes            = true;
+                    changes = true;
                 }
             }
-            pointer++;
         }
 
         // Normalize the diff.
         if (changes) {
-            diff_cleanupMerge(diffs, pool);
+            diff_cleanupMerge(diffs, pool, &eliminated);
         }
-        diff_cleanupSemanticLossless(diffs, pool);
 
         // Find any overlaps between deletions and insertions.
         // e.g: <del>abcxxx</del><ins>xxxdef</ins>
@@ -846,40 +2491,67 @@ public:
         // e.g: <del>xxxabc</del><ins>defxxx</ins>
         //   -> <ins>def</ins>xxx<del>abc</del>
         // Only extract an overlap if it is as big as the edit ahead or behind it.
-        pointer = 1;
-        while (static_cast<size_t>(pointer) < diffs.size()) {
-            if (diffs[static_cast<size_t>(pointer - 1)].operation == Operation::DELETE && diffs[static_cast<size_t>(pointer)].operation == Operation::INSERT) {
-                string_view_t deletion        = diffs[static_cast<size_t>(pointer - 1)].text;
-                string_view_t insertion       = diffs[static_cast<size_t>(pointer)].text;
-                auto          overlap_length1 = commons::diff_commonOverlap(deletion, insertion);
-                auto          overlap_length2 = commons::diff_commonOverlap(insertion, deletion);
-                if (overlap_length1 >= overlap_length2) {
-                    if (static_cast<double>(overlap_length1) >= static_cast<double>(deletion.length()) / 2.0 || static_cast<double>(overlap_length1) >= static_cast<double>(insertion.length()) / 2.0) {
-                        // Overlap found.
-                        // Insert an equality and trim the surrounding edits.
-                        diffs.splice(pointer < 0 ? 0 : static_cast<size_t>(pointer), 0,
-                                     diff_t(Operation::EQUAL, insertion.substring(0, overlap_length1)));
-                        diffs[static_cast<size_t>(pointer - 1)].text = deletion.substring(0, deletion.length() - overlap_length1);
-                        diffs[static_cast<size_t>(pointer + 1)].text = insertion.substring(overlap_length1);
-                        pointer++;
-                    }
-                } else {
-                    if (static_cast<double>(overlap_length2) >= static_cast<double>(deletion.length()) / 2.0 || static_cast<double>(overlap_length2) >= static_cast<double>(insertion.length()) / 2.0) {
-                        // Reverse overlap found.
-                        // Insert an equality and swap and trim the surrounding edits.
-                        diffs.splice(pointer < 0 ? 0 : static_cast<size_t>(pointer), 0,
-                                     diff_t(Operation::EQUAL, deletion.substring(0, overlap_length2)));
-                        diffs[static_cast<size_t>(pointer - 1)].operation = Operation::INSERT;
-                        diffs[static_cast<size_t>(pointer - 1)].text      = insertion.substring(0, insertion.length() - overlap_length2);
-                        diffs[static_cast<size_t>(pointer + 1)].operation = Operation::DELETE;
-                        diffs[static_cast<size_t>(pointer + 1)].text      = deletion.substring(overlap_length2);
-                        pointer++;
-                    }
-                }
-                pointer++;
+        // The overlaps are found while shifting the edits, and the equalities
+        // inserted afterwards.
+        size_t overlaps = diff_cleanupSemanticLossless(diffs, pool, &eliminated);
+        if (overlaps == 0) {
+            return;
+        }
+
+        // Insert the equalities and trim the surrounding edits, back to front.
+        size_t read  = diffs.size();
+        size_t write = read + overlaps;
+        diffs.resize(write);
+        while (read > 0) {
+            read--;
+            if (eliminated[read] == 0) {
+                diffs[--write] = diffs[read];
+                continue;
+            }
+
+            string_view_t deletion  = diffs[read - 1].text;
+            string_view_t insertion = diffs[read].text;
+            if (eliminated[read] > 0) {
+                // Insert an equality and trim the surrounding edits.
+                size_t overlap_length = static_cast<size_t>(eliminated[read] - 1);
+                diffs[--write]        = diff_t(Operation::INSERT, insertion.substring(overlap_length));
+                diffs[--write]        = diff_t(Operation::EQUAL, insertion.substring(0, overlap_length));
+                diffs[--write]        = diff_t(Operation::DELETE, deletion.substring(0, deletion.length() - overlap_length));
+            } else {
+                // Insert an equality and swap and trim the surrounding edits.
+                size_t overlap_length = static_cast<size_t>(-eliminated[read] - 1);
+                diffs[--write]        = diff_t(Operation::DELETE, deletion.substring(overlap_length));
+                diffs[--write]        = diff_t(Operation::EQUAL, deletion.substring(0, overlap_length));
+                diffs[--write]        = diff_t(Operation::INSERT, insertion.substring(0, insertion.length() - overlap_length));
+            }
+            read--;
+        }
+    }
+
+    /**
+     * Check a deletion followed by an insertion for an overlap to extract,
+     * see diff_cleanupSemantic.
+     * @param deletion Text of the deletion.
+     * @param insertion Text of the insertion.
+     * @return 0 if there is none, else the overlap length + 1, negated for an
+     *     overlap of the end of the insertion with the start of the deletion.
+     */
+private:
+    inline static constexpr int diff_overlap(string_view_t deletion, string_view_t insertion) noexcept {
+        auto overlap_length1 = commons::diff_commonOverlap(deletion, insertion);
+        auto overlap_length2 = commons::diff_commonOverlap(insertion, deletion);
+        if (overlap_length1 >= overlap_length2) {
+            if (static_cast<double>(overlap_length1) >= static_cast<double>(deletion.length()) / 2.0 || static_cast<double>(overlap_length1) >= static_cast<double>(insertion.length()) / 2.0) {
+                // Overlap found.
+                return static_cast<int>(overlap_length1) + 1;
+            }
+        } else {
+            if (static_cast<double>(overlap_length2) >= static_cast<double>(deletion.length()) / 2.0 || static_cast<double>(overlap_length2) >= static_cast<double>(insertion.length()) / 2.0) {
+                // Reverse overlap found.
+                return -static_cast<int>(overlap_length2) - 1;
             }
-            pointer++;
         }
+        return 0;
     }
 
 
@@ -891,81 +2563,153 @@ public:
      */
 public:
     inline static constexpr void diff_cleanupSemanticLossless(diffs_t& diffs, string_pool_t& pool) noexcept {
+        diff_cleanupSemanticLossless(diffs, pool, nullptr);
+    }
+
+    /**
+     * diff_cleanupSemanticLossless, also recording the diff_overlap of each
+     * deletion followed by an insertion at the index of the insertion.
+     * @return The number of overlaps found.
+     */
+protected:
+    inline static constexpr size_t diff_cleanupSemanticLossless(diffs_t& diffs, string_pool_t& pool, bisect_list_t* overlaps) noexcept {
         if (diffs.size() <= 0) {
-            return;
+            return 0;
+        }
+
+        if (overlaps) {
+            overlaps->clear();
+            overlaps->resize(diffs.size(), 0);
         }
 
-        size_t pointer = 1;
+        // The diffs are compacted in place: diffs[0, write) are the diffs before
+        // the current one, diffs[read].  The overlaps are recorded when an
+        // insertion is written and dropped if it is read again.
+        size_t size  = diffs.size();
+        size_t write = 1;
+        size_t read  = 1;
+        size_t count = 0;
+        auto   next  = [&]() {
+            diffs[write] = diffs[read++];
+            if (overlaps && write > 0 && diffs[write - 1].operation == Operation::DELETE && diffs[write].operation == Operation::INSERT) {
+                (*overlaps)[write] = diff_overlap(diffs[write - 1].text, diffs[write].text);
+                count += (*overlaps)[write] != 0 ? 1u : 0u;
+            }
+            write++;
+        };
         // Intentionally ignore the first and last element (don't need checking).
-        while (pointer < diffs.size() - 1) {
-            if (diffs[pointer - 1].operation == Operation::EQUAL && diffs[pointer + 1].operation == Operation::EQUAL) {
-                // This is a single edit surrounded by equalities.
-                string_view_t equality1 = diffs[pointer - 1].text;
-                string_view_t edit      = diffs[pointer].text;
-                string_view_t equality2 = diffs[pointer + 1].text;
+        while (read + 1 < size) {
+            if (diffs[write - 1].operation == Operation::EQUAL && diffs[read + 1].operation == Operation::EQUAL) {
+                // This is a single edit surrounded by equalities.  Shifting the
+                // edit keeps equality1 + edit + equality2 the same, so the edit is
+                // moved by its offset in that text and the strings are only built
+                // for the best fit.
+                semantic_text text { { diffs[write - 1].text, diffs[read].text, diffs[read + 1].text } };
+                size_t        length     = text.length();
+                size_t        editLength = text.parts[1].length();
 
                 // First, shift the edit as far left as possible.
-                auto commonOffset = commons::diff_commonSuffix(equality1, edit);
-                if (commonOffset > 0) {
-                    string_view_t commonString = edit.substring(edit.length() - commonOffset);
-                    equality1                  = equality1.substring(0, equality1.length() - commonOffset);
-                    edit                       = pool.appended(commonString, edit.substring(0, edit.length() - commonOffset));
-                    equality2                  = pool.appended(commonString, equality2);
-                }
+                size_t offset = text.parts[0].length() - commons::diff_commonSuffix(text.parts[0], text.parts[1]);
 
                 // Second, step character by character right,
                 // looking for the best fit.
-                string_view_t bestEquality1 = equality1;
-                string_view_t bestEdit      = edit;
-                string_view_t bestEquality2 = equality2;
-                auto          bestScore     = diff_cleanupSemanticScore(equality1, edit) + diff_cleanupSemanticScore(edit, equality2);
-                while (edit.length() != 0 && equality2.length() != 0 && *edit.begin() == *equality2.begin()) {
-                    pool.append(equality1, edit.substring(0, 1));
-                    edit       = pool.appended(edit.substring(1), equality2.substring(0, 1));
-                    equality2  = equality2.substring(1);
-                    auto score = diff_cleanupSemanticScore(equality1, edit) + diff_cleanupSemanticScore(edit, equality2);
+                size_t bestOffset = offset;
+                auto   bestScore  = diff_cleanupSemanticScore(text, 0, offset, offset + editLength) +
+                                 diff_cleanupSemanticScore(text, offset, offset + editLength, length);
+                while (editLength != 0 && offset + editLength < length && text[offset] == text[offset + editLength]) {
+                    offset++;
+                    auto score = diff_cleanupSemanticScore(text, 0, offset, offset + editLength) +
+                                 diff_cleanupSemanticScore(text, offset, offset + editLength, length);
                     // The >= encourages trailing rather than leading whitespace on
                     // edits.
                     if (score >= bestScore) {
-                        bestScore     = score;
-                        bestEquality1 = equality1;
-                        bestEdit      = edit;
-                        bestEquality2 = equality2;
+                        bestScore  = score;
+                        bestOffset = offset;
                     }
                 }
 
-                if (diffs[pointer - 1].text != bestEquality1) {
+                if (bestOffset != text.parts[0].length()) {
                     // We have an improvement, save it back to the diff.
-                    if (bestEquality1.length() != 0) {
-                        diffs[pointer - 1].text = bestEquality1;
+                    if (bestOffset != 0) {
+                        diffs[write - 1].text = text.substring(pool, 0, bestOffset);
                     } else {
-                        diffs.splice(pointer - 1, 1);
-                        pointer--;
+                        write--;
                     }
-                    diffs[pointer].text = bestEdit;
-                    if (bestEquality2.length() != 0) {
-                        diffs[pointer + 1].text = bestEquality2;
+                    diffs[read].text = text.substring(pool, bestOffset, bestOffset + editLength);
+                    if (bestOffset + editLength != length) {
+                        diffs[read + 1].text = text.substring(pool, bestOffset + editLength, length);
                     } else {
-                        diffs.splice(pointer + 1, 1);
-                        pointer--;
+                        // Drop the next equality and look at the diff before the
+                        // edit again.
+                        diffs[read + 1] = diffs[read];
+                        read++;
+                        if (write > 0) {
+                            diffs[--read] = diffs[--write];
+                            if (overlaps && (*overlaps)[write] != 0) {
+                                (*overlaps)[write] = 0;
+                                count--;
+                            }
+                        }
                     }
                 }
             }
-            pointer++;
+            next();
         }
+        while (read < size) {
+            next();
+        }
+        diffs.resize(write);
+        return count;
     }
 
     /**
-     * Given two strings, compute a score representing whether the internal
-     * boundary falls on logical boundaries.
+     * An equality, an edit and an equality of diff_cleanupSemanticLossless read
+     * as one text.
+     */
+private:
+    struct semantic_text {
+        string_view_t parts[3];
+
+        inline constexpr size_t length() const noexcept { return parts[0].length() + parts[1].length() + parts[2].length(); }
+
+        inline constexpr char_t operator[](size_t index) const noexcept {
+            for (const auto& part : parts) {
+                if (index < part.length()) {
+                    return part.data()[index];
+                }
+                index -= part.length();
+            }
+            return char_t {};
+        }
+
+        inline constexpr string_view_t substring(string_pool_t& pool, size_t from, size_t to) const noexcept {
+            return pool.joined(3, [&](size_t i) {
+                size_t start = 0;
+                for (size_t j = 0; j < i; j++) {
+                    start += parts[j].length();
+                }
+                size_t end   = start + parts[i].length();
+                size_t first = from > start ? from : start;
+                size_t last  = to < end ? to : end;
+                return first < last ? parts[i].substring(first - start, last - first) : string_view_t {};
+            });
+        }
+    };
+
+    /**
+     * Given the strings one = text[start, position) and two = text[position, end),
+     * compute a score representing whether the internal boundary falls on
+     * logical boundaries.
      * Scores range from 6 (best) to 0 (worst).
-     * @param one First string.
-     * @param two Second string.
+     * @param text The text holding both strings.
+     * @param start Offset of the first string.
+     * @param position Offset of the boundary.
+     * @param end End offset of the second string.
      * @return The score.
      */
 private:
-    inline static constexpr int diff_cleanupSemanticScore(string_view_t one, string_view_t two) noexcept {
-        if (one.length() == 0 || two.length() == 0) {
+    inline static constexpr int diff_cleanupSemanticScore(const semantic_text& text, size_t start, size_t position, size_t end) noexcept {
+        if (position == start || position == end) {
             // Edges are the best.
             return 6;
         }
@@ -975,48 +2719,34 @@ private:
         // 'whitespace'.  Since this function's purpose is largely cosmetic,
         // the choice has been made to use each language's native features
         // rather than force total conformity.
-        auto char1            = *(one.begin() + one.length() - 1);
-        auto char2            = *two.begin();
-        bool nonAlphaNumeric1 = !char_traits::isAlphaNum(char1);
-        bool nonAlphaNumeric2 = !char_traits::isAlphaNum(char2);
-        bool whitespace1      = nonAlphaNumeric1 && char_traits::isSpace(char1);
-        bool whitespace2      = nonAlphaNumeric2 && char_traits::isSpace(char2);
-        bool lineBreak1       = whitespace1 && char_traits::isControl(char1);
-        bool lineBreak2       = whitespace2 && char_traits::isControl(char2);
+        auto class1           = char_traits::charClass(text[position - 1]);
+        auto class2           = char_traits::charClass(text[position]);
+        bool nonAlphaNumeric1 = !(class1 & utils::CHAR_CLASS_ALPHANUM);
+        bool nonAlphaNumeric2 = !(class2 & utils::CHAR_CLASS_ALPHANUM);
+        bool whitespace1      = nonAlphaNumeric1 && (class1 & utils::CHAR_CLASS_SPACE);
+        bool whitespace2      = nonAlphaNumeric2 && (class2 & utils::CHAR_CLASS_SPACE);
+        bool lineBreak1       = whitespace1 && (class1 & utils::CHAR_CLASS_LINEBREAK);
+        bool lineBreak2       = whitespace2 && (class2 & utils::CHAR_CLASS_LINEBREAK);
 
         bool blankLine1 = false;
-        if (lineBreak1) {
-            auto d1(one.data());
-            int  p1n(static_cast<int>(one.length()));
-            auto p1(d1 + p1n - 1);
-
-            auto p2(d1);
-            if (*p1 == char_traits::eol) {
-                p1n--;
-                p1 = d1 + p1n - 1;
-                if (p1 != p2) {
-                    if (*p1 == char_traits::ret) {
-                        p1n--;
-                        p1 = d1 + p1n - 1;
-                    }
-                    blankLine1 = p1 != p2 && *p1 == char_traits::eol;
-                }
+        if (lineBreak1 && position - start >= 2 && text[position - 1] == char_traits::eol) {
+            auto p1(position - 2);
+            if (text[p1] == char_traits::ret && p1 > start) {
+                p1--;
             }
+            blankLine1 = text[p1] == char_traits::eol;
         }
         bool blankLine2 = false;
         if (lineBreak2) {
-            auto p1(two.end());
-            auto p2(two.begin());
-            if (*p2 == char_traits::ret) {
+            auto p2(position);
+            if (text[p2] == char_traits::ret) {
                 ++p2;
             }
-            if (p2 != p1 && *p2 == char_traits::eol) {
-                if (++p2 != p1 && *p2 == char_traits::ret) {
+            if (p2 != end && text[p2] == char_traits::eol) {
+                if (++p2 != end && text[p2] == char_traits::ret) {
                     ++p2;
                 }
-                if (p2 != p1 && *p2 == char_traits::eol) {
-                    blankLine2 = true;
-                }
+                blankLine2 = p2 != end && text[p2] == char_traits::eol;
             }
         }
 
@@ -1051,18 +2781,34 @@ private:
      */
 public:
     inline static constexpr void diff_cleanupEfficiency(const settings_t& settings, diffs_t& diffs, string_pool_t& pool) noexcept {
+        equalities_list_t equalities;
+        bisect_list_t     eliminated;
+        diff_cleanupEfficiency(settings, diffs, pool, equalities, eliminated);
+    }
+
+public:
+    inline static constexpr void diff_cleanupEfficiency(const settings_t& settings, diffs_t& diffs, string_pool_t& pool,
+                                                        diff_workspace& workspace) noexcept {
+        diff_cleanupEfficiency(settings, diffs, pool, workspace.equalities, workspace.eliminated);
+    }
+
+protected:
+    inline static constexpr void diff_cleanupEfficiency(const settings_t& settings, diffs_t& diffs, string_pool_t& pool,
+                                                        equalities_list_t& equalities, bisect_list_t& eliminated) noexcept {
         if (diffs.size() <= 0) {
             return;
         }
 
         bool changes = false;
-        // Stack of indices where equalities are found.
-        using List = typename container_traits::template equalities_list<int>;
-        List equalities;
+        // Stack of equalities which are not eliminated (yet).
+        equalities.clear();
         equalities.reserve(64);
-        // Always equal to equalities[equalitiesLength-1][1]
-        string_view_t lastEquality {};
-        int           pointer = 0;  // Index of current position.
+        // Equalities are only marked here and split into edits once at the end,
+        // a marked equality counts as an insertion and a deletion.
+        eliminated.clear();
+        eliminated.resize(diffs.size(), 0);
+        // Always equal to the length of equalities.back(), 0 if there is none.
+        size_t lastEquality_length = 0;
         // Is there an insertion operation before the last equality.
         bool pre_ins = false;
         // Is there a deletion operation before the last equality.
@@ -1071,22 +2817,34 @@ public:
         bool post_ins = false;
         // Is there a deletion operation after the last equality.
         bool post_del = false;
-        while (static_cast<size_t>(pointer) < diffs.size()) {
-            if (diffs[static_cast<size_t>(pointer)].operation == Operation::EQUAL) {  // Equality found.
-                if (diffs[static_cast<size_t>(pointer)].text.length() < static_cast<size_t>(settings.Diff_EditCost) && (post_ins || post_del)) {
+        // Scanning from the start again reaches the same state right after the
+        // last equality which can never be a candidate, unless an elimination
+        // has cleared the stack since.  So rescans start there.
+        size_t restart = 0;
+        bool   cleared = false;
+        size_t pointer = 0;  // Index of current position.
+        while (pointer < diffs.size()) {
+            size_t next = pointer + 1;
+            if (diffs[pointer].operation == Operation::EQUAL && eliminated[pointer] == 0) {  // Equality found.
+                if (diffs[pointer].text.length() < static_cast<size_t>(settings.Diff_EditCost) && (post_ins || post_del)) {
                     // Candidate found.
-                    equalities.push_back(pointer);
-                    pre_ins      = post_ins;
-                    pre_del      = post_del;
-                    lastEquality = diffs[static_cast<size_t>(pointer)].text;
+                    equalities.push_back(equality_t {pointer, post_ins ? 1u : 0u, post_del ? 1u : 0u});
+                    pre_ins             = post_ins;
+                    pre_del             = post_del;
+                    lastEquality_length = diffs[pointer].text.length();
                 } else {
                     // Not a candidate, and can never become one.
                     equalities.clear();
-                    lastEquality = string_view_t {};
+                    lastEquality_length = 0;
+                    if (!cleared && diffs[pointer].text.length() >= static_cast<size_t>(settings.Diff_EditCost)) {
+                        restart = next;
+                    }
                 }
                 post_ins = post_del = false;
             } else {  // An insertion or deletion.
-                if (diffs[static_cast<size_t>(pointer)].operation == Operation::DELETE) {
+                if (eliminated[pointer] != 0) {
+                    post_ins = post_del = true;
+                } else if (diffs[pointer].operation == Operation::DELETE) {
                     post_del = true;
                 } else {
                     post_ins = true;
@@ -1099,47 +2857,57 @@ public:
                  * <ins>A</del>X<ins>C</ins><del>D</del>
                  * <ins>A</ins><del>B</del>X<del>C</del>
                  */
-                if ((lastEquality.length() != 0)
-                    && ((pre_ins && pre_del && post_ins && post_del)
-                        || ((lastEquality.length() < static_cast<size_t>(settings.Diff_EditCost / 2))
-                            && ((pre_ins ? 1 : 0) + (pre_del ? 1 : 0) + (post_ins ? 1 : 0) + (post_del ? 1 : 0)) == 3))) {
-                    // Duplicate record.
-                    diffs.splice(static_cast<size_t>(equalities.back()), 0, diff_t(Operation::DELETE, lastEquality));
-                    // Change second copy to insert.
-                    diffs[static_cast<size_t>(equalities.back() + 1)].operation = Operation::INSERT;
+                while ((lastEquality_length != 0)
+                       && ((pre_ins && pre_del && post_ins && post_del)
+                           || ((lastEquality_length < static_cast<size_t>(settings.Diff_EditCost / 2))
+                               && ((pre_ins ? 1 : 0) + (pre_del ? 1 : 0) + (post_ins ? 1 : 0) + (post_del ? 1 : 0)) == 3))) {
+                    eliminated[equalities.back().index] = 1;
                     equalities.pop_back();  // Throw away the equality we just deleted.
-                    lastEquality = string_view_t {};
+                    lastEquality_length = 0;
+                    changes             = true;
                     if (pre_ins && pre_del) {
                         // No changes made which could affect previous entry, keep going.
                         post_ins = post_del = true;
                         equalities.clear();
+                        cleared = true;
+                    } else if (equalities.size() > 1) {
+                        // Scanning again from the equality before the previous one
+                        // finds the previous one followed by both kinds of edits.
+                        pre_ins             = equalities.back().insertions != 0;
+                        pre_del             = equalities.back().deletions != 0;
+                        lastEquality_length = diffs[equalities.back().index].text.length();
+                        post_ins = post_del = true;
                     } else {
-                        if (equalities.size() > 0) {
-                            equalities.pop_back();
-                        }
-
-                        pointer  = equalities.size() > 0 ? equalities.back() : -1;
+                        equalities.clear();
+                        next     = restart;
+                        cleared  = false;
                         post_ins = post_del = false;
                     }
-                    changes = true;
                 }
             }
-            pointer++;
+            pointer = next;
         }
 
         if (changes) {
-            diff_cleanupMerge(diffs, pool);
+            diff_cleanupMerge(diffs, pool, &eliminated);
         }
     }
 
-
     /**
      * Reorder and merge like edit sections.  Merge equalities.
      * Any edit section can move as long as it doesn't cross an equality.
      * @param diffs List of Diff objects.
      */
 public:
-    inline static constexpr void diff_cleanupMerge(diffs_t& diffs, string_pool_t& pool) noexcept {
+    inline static constexpr void diff_cleanupMerge(diffs_t& diffs, string_pool_t& pool) noexcept { diff_cleanupMerge(diffs, pool, nullptr); }
+
+    /**
+     * diff_cleanupMerge, with the equalities marked in eliminated merged as
+     * a deletion and an insertion of their text.
+     * Every section of edits has an edit which isn't marked.
+     */
+protected:
+    inline static constexpr void diff_cleanupMerge(diffs_t& diffs, string_pool_t& pool, const bisect_list_t* eliminated) noexcept {
         if (diffs.size() <= 0) {
             return;
         }
@@ -1147,83 +2915,87 @@ public:
         // Add a dummy entry at the end.
         diffs.push_back(diff_t(Operation::EQUAL, string_view_t {}));
 
-        size_t        pointer      = 0;
-        size_t        count_delete = 0;
-        size_t        count_insert = 0;
-        string_view_t text_delete  = {};
-        string_view_t text_insert  = {};
-        size_t        commonlength = 0;
-        while (pointer < diffs.size()) {
-            switch (diffs[pointer].operation) {
-                case Operation::INSERT:
+        // The diffs are compacted in place: diffs[0, write) is the merged
+        // result so far, diffs[start, read) the edits since.
+        size_t size    = diffs.size();
+        size_t shifted = 0;
+        auto   marked  = [&](size_t index) {
+            return eliminated && index - shifted < eliminated->size() && (*eliminated)[index - shifted] != 0;
+        };
+        size_t write        = 0;
+        size_t start        = 0;
+        size_t commonlength = 0;
+        for (size_t read = 0; read < size; read++) {
+            if (diffs[read].operation != Operation::EQUAL || marked(read)) {
+                continue;
+            }
+
+            // Upon reaching an equality, check for prior redundancies.
+            size_t count_delete = 0;
+            size_t count_insert = 0;
+            for (size_t i = start; i < read; i++) {
+                if (marked(i)) {
+                    count_delete++;
                     count_insert++;
-                    pool.append(text_insert, diffs[pointer].text);
-                    pointer++;
-                    break;
-                case Operation::DELETE:
+                } else if (diffs[i].operation == Operation::DELETE) {
                     count_delete++;
-                    pool.append(text_delete, diffs[pointer].text);
-                    pointer++;
-                    break;
-                case Operation::EQUAL:
-                    // Upon reaching an equality, check for prior redundancies.
-                    if (count_delete + count_insert > 1) {
-                        if (count_delete != 0 && count_insert != 0) {
-                            // Factor out any common prefixies.
-                            commonlength = commons::diff_commonPrefix(text_insert, text_delete);
-                            if (commonlength != 0) {
-                                if ((pointer - count_delete - count_insert) > 0
-                                    && diffs[pointer - count_delete - count_insert - 1].operation == Operation::EQUAL) {
-                                    pool.append(diffs[pointer - count_delete - count_insert - 1].text, text_insert.substring(0, commonlength));
-                                } else {
-                                    diffs.push_front(diff_t(Operation::EQUAL, text_insert.substring(0, commonlength)));
-                                    pointer++;
-                                }
-                                text_insert = text_insert.substring(commonlength);
-                                text_delete = text_delete.substring(commonlength);
-                            }
-                            // Factor out any common suffixies.
-                            commonlength = commons::diff_commonSuffix(text_insert, text_delete);
-                            if (commonlength != 0) {
-                                diffs[pointer].text = pool.appended(text_insert.substring(text_insert.length() - commonlength), diffs[pointer].text);
-                                text_insert         = text_insert.substring(0, text_insert.length() - commonlength);
-                                text_delete         = text_delete.substring(0, text_delete.length() - commonlength);
-                            }
-                        }
-                        // Delete the offending records and add the merged ones.
-                        pointer -= count_delete + count_insert;
-
-                        if (text_delete.length() != 0 && text_insert.length() != 0) {
-                            diffs.splice(pointer, count_delete + count_insert, diff_t(Operation::DELETE, text_delete),
-                                         diff_t(Operation::INSERT, text_insert));
-                            pointer += 2;
-
-                        } else if (text_delete.length() != 0) {
-                            diffs.splice(pointer, count_delete + count_insert, diff_t(Operation::DELETE, text_delete));
-                            pointer++;
-
-                        } else if (text_insert.length() != 0) {
-                            diffs.splice(pointer, count_delete + count_insert, diff_t(Operation::INSERT, text_insert));
-                            pointer++;
+                } else {
+                    count_insert++;
+                }
+            }
 
+            if (count_delete + count_insert > 1) {
+                string_view_t text_delete = pool.joined(read - start, [&](size_t i) {
+                    return diffs[start + i].operation != Operation::INSERT || marked(start + i) ? diffs[start + i].text : string_view_t {};
+                });
+                string_view_t text_insert = pool.joined(read - start, [&](size_t i) {
+                    return diffs[start + i].operation != Operation::DELETE || marked(start + i) ? diffs[start + i].text : string_view_t {};
+                });
+                if (count_delete != 0 && count_insert != 0) {
+                    // Factor out any common prefixies.
+                    commonlength = commons::diff_commonPrefix(text_insert, text_delete);
+                    if (commonlength != 0) {
+                        if (write > 0 && diffs[write - 1].operation == Operation::EQUAL) {
+                            pool.append(diffs[write - 1].text, text_insert.substring(0, commonlength));
                         } else {
-                            diffs.splice(pointer, count_delete + count_insert);
+                            diffs.push_front(diff_t(Operation::EQUAL, text_insert.substring(0, commonlength)));
+                            size++;
+                            shifted++;
+                            write++;
+                            read++;
                         }
-                        pointer++;
-                    } else if (pointer != 0 && diffs[pointer - 1].operation == Operation::EQUAL) {
-                        // Merge this equality with the previous one.
-                        pool.append(diffs[pointer - 1].text, diffs[pointer].text);
-                        diffs.splice(pointer, 1);
-                    } else {
-                        pointer++;
+                        text_insert = text_insert.substring(commonlength);
+                        text_delete = text_delete.substring(commonlength);
                     }
-                    count_insert = 0;
-                    count_delete = 0;
-                    text_delete  = string_view_t {};
-                    text_insert  = string_view_t {};
-                    break;
+                    // Factor out any common suffixies.
+                    commonlength = commons::diff_commonSuffix(text_insert, text_delete);
+                    if (commonlength != 0) {
+                        diffs[read].text = pool.appended(text_insert.substring(text_insert.length() - commonlength), diffs[read].text);
+                        text_insert      = text_insert.substring(0, text_insert.length() - commonlength);
+                        text_delete      = text_delete.substring(0, text_delete.length() - commonlength);
+                    }
+                }
+
+                // Replace the offending records by the merged ones.
+                if (text_delete.length() != 0) {
+                    diffs[write++] = diff_t(Operation::DELETE, text_delete);
+                }
+                if (text_insert.length() != 0) {
+                    diffs[write++] = diff_t(Operation::INSERT, text_insert);
+                }
+                diffs[write++] = diffs[read];
+            } else if (start < read) {
+                diffs[write++] = diffs[start];
+                diffs[write++] = diffs[read];
+            } else if (write != 0 && diffs[write - 1].operation == Operation::EQUAL) {
+                // Merge this equality with the previous one.
+                pool.append(diffs[write - 1].text, diffs[read].text);
+            } else {
+                diffs[write++] = diffs[read];
             }
+            start = read + 1;
         }
+        diffs.resize(write);
         if (diffs[diffs.size() - 1].text.length() == 0) {
             diffs.pop_back();  // Remove the dummy entry at the end.
         }
@@ -1231,36 +3003,48 @@ public:
         // Second pass: look for single edits surrounded on both sides by
         // equalities which can be shifted sideways to eliminate an equality.
         // e.g: A<ins>BA</ins>C -> <ins>AB</ins>AC
-        bool changes = false;
-        pointer      = 1;
+        bool   changes = false;
+        size_t read    = 1;
+        size           = diffs.size();
+        write          = 1;
         // Intentionally ignore the first and last element (don't need checking).
-        while (pointer < (diffs.size() - 1)) {
-            if (diffs[pointer - 1].operation == Operation::EQUAL && diffs[pointer + 1].operation == Operation::EQUAL) {
+        while (read + 1 < size) {
+            diff_t& previous = diffs[write - 1];
+            diff_t& edit     = diffs[read];
+            diff_t& next     = diffs[read + 1];
+            if (previous.operation == Operation::EQUAL && next.operation == Operation::EQUAL) {
                 // This is a single edit surrounded by equalities.
-                if (diffs[pointer].text.endsWith(diffs[pointer - 1].text)) {
+                if (edit.text.endsWith(previous.text)) {
                     // Shift the edit over the previous equality.
-                    diffs[pointer].text = pool.appended(
-                        diffs[pointer - 1].text, diffs[pointer].text.substring(0, diffs[pointer].text.length() - diffs[pointer - 1].text.length()));
-                    diffs[pointer + 1].text = pool.appended(diffs[pointer - 1].text, diffs[pointer + 1].text);
-                    diffs.splice(pointer - 1, 1);
-                    changes = true;
-                } else if (diffs[pointer].text.startsWith(diffs[pointer + 1].text)) {
+                    edit.text = pool.appended(previous.text, edit.text.substring(0, edit.text.length() - previous.text.length()));
+                    next.text = pool.appended(previous.text, next.text);
+                    write--;
+                    diffs[write++] = diffs[read++];
+                    diffs[write++] = diffs[read++];
+                    changes        = true;
+                    continue;
+                } else if (edit.text.startsWith(next.text)) {
                     // Shift the edit over the next equality.
-                    pool.append(diffs[pointer - 1].text, diffs[pointer + 1].text);
-                    diffs[pointer].text = pool.appended(diffs[pointer].text.substring(diffs[pointer + 1].text.length()), diffs[pointer + 1].text);
-                    diffs.splice(pointer + 1, 1);
+                    pool.append(previous.text, next.text);
+                    edit.text      = pool.appended(edit.text.substring(next.text.length()), next.text);
+                    diffs[write++] = diffs[read];
+                    read += 2;
                     changes = true;
+                    continue;
                 }
             }
-            pointer++;
+            diffs[write++] = diffs[read++];
         }
+        while (read < size) {
+            diffs[write++] = diffs[read++];
+        }
+        diffs.resize(write);
         // If shifts were made, the diff needs reordering and another shift sweep.
         if (changes) {
             diff_cleanupMerge(diffs, pool);
         }
     }
 
-
     /**
      * loc is a location in text1, compute and return the equivalent location in
      * text2.
@@ -1301,6 +3085,60 @@ public:
         return last_chars2 + (loc - last_chars1);
     }
 
+    /**
+     * Prepare the offsets of a diff list for translating many locations with
+     * diff_xIndex.
+     * @param diffs List of Diff objects.
+     * @param offsets Receives the offsets of the diffs.
+     */
+public:
+    inline static constexpr void diff_xIndexPrepare(const diffs_t& diffs, diff_offsets& offsets) noexcept {
+        offsets.chars1.clear();
+        offsets.chars2.clear();
+        size_t chars1 = 0;
+        size_t chars2 = 0;
+        for (auto& d : diffs) {
+            if (d.operation != Operation::INSERT) {
+                chars1 += d.text.length();
+            }
+            if (d.operation != Operation::DELETE) {
+                chars2 += d.text.length();
+            }
+            offsets.chars1.push_back(chars1);
+            offsets.chars2.push_back(chars2);
+        }
+    }
+
+    /**
+     * diff_xIndex on the offsets of a diff list, in O(log n).
+     * @param offsets Offsets prepared by diff_xIndexPrepare.
+     * @param loc Location within text1.
+     * @return Location within text2.
+     */
+public:
+    inline static constexpr size_t diff_xIndex(const diff_offsets& offsets, size_t loc) noexcept {
+        // Find the diff overshooting the location.
+        size_t low  = 0;
+        size_t high = offsets.chars1.size();
+        while (low < high) {
+            size_t mid = low + (high - low) / 2;
+            if (offsets.chars1[mid] > loc) {
+                high = mid;
+            } else {
+                low = mid + 1;
+            }
+        }
+        size_t last_chars1 = low > 0 ? offsets.chars1[low - 1] : 0;
+        size_t last_chars2 = low > 0 ? offsets.chars2[low - 1] : 0;
+        if (low < offsets.chars2.size() && offsets.chars2[low] == last_chars2) {
+            // The location was deleted, only a deletion overshoots without
+            // moving in text2.
+            return last_chars2;
+        }
+        // Add the remaining character length.
+        return last_chars2 + (loc - last_chars1);
+    }
+
     /**
      * Given the original text1, and an encoded string which describes the
      * operations required to transform text1 into text2, compute the full diff.
@@ -1388,6 +3226,251 @@ public:
 
         return true;
     }
+
+    /**
+     * Given the original text1 and a delta of diff_toDelta, compute the
+     * length of text2 without building it.
+     * @param text1 Source string for the diff.
+     * @param delta Delta text.
+     * @return Length of text2 or npos if the delta is invalid.
+     */
+public:
+    inline static constexpr size_t diff_deltaLength(string_view_t text1, string_view_t delta) noexcept {
+        size_t length = 0;
+        if (!diff_walkDelta(text1, delta, [&length](string_view_t piece) {
+                length += piece.length();
+                return true;
+            })) {
+            return npos;
+        }
+        return length;
+    }
+
+    /**
+     * Given the original text1 and a delta of diff_toDelta, write text2 to
+     * the stream in a single pass, without the diff list in between.
+     * @param s Stream receiving text2.
+     * @param text1 Source string for the diff.
+     * @param delta Delta text.
+     * @return false if the delta is invalid, the stream holds the part of
+     *     text2 before the first invalid token then.
+     */
+public:
+    template <typename Stream>
+    inline static constexpr bool diff_applyDelta(Stream& s, string_view_t text1, string_view_t delta) noexcept {
+        using namespace dmp::utils;
+
+        return diff_walkDelta(text1, delta, [&s](string_view_t piece) {
+            writeToStream(s, piece);
+            return true;
+        });
+    }
+
+    /**
+     * Given the original text1 and a delta of diff_toDelta, append text2 to
+     * the string in a single pass.
+     * @param text2 String receiving text2, unchanged if the delta is invalid.
+     * @param text1 Source string for the diff.
+     * @param delta Delta text.
+     * @return false if the delta is invalid.
+     */
+public:
+    inline static constexpr bool diff_applyDelta(owning_string_t& text2, string_view_t text1, string_view_t delta) noexcept {
+        using namespace dmp::utils;
+
+        size_t length(get_length(text2));
+        if (!diff_walkDelta(text1, delta, [&text2](string_view_t piece) {
+                str_append(text2, piece);
+                return true;
+            })) {
+            str_resize(text2, length);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Given the original text1 and a delta of diff_toDelta, copy text2 into
+     * the buffer.  diff_deltaLength tells the size the buffer needs.
+     * @param buffer Buffer receiving text2.
+     * @param size Size of the buffer on input, length of text2 on output,
+     *     unchanged if the delta is invalid or text2 doesn't fit.
+     * @param text1 Source string for the diff.
+     * @param delta Delta text.
+     * @return false if the delta is invalid or text2 doesn't fit.
+     */
+public:
+    inline static constexpr bool diff_applyDelta(char_t* buffer, size_t& size, string_view_t text1, string_view_t delta) noexcept {
+        using namespace dmp::utils;
+
+        auto   p(buffer);
+        size_t l(size);
+        if (!diff_walkDelta(text1, delta, [&p, &l](string_view_t piece) {
+                if (piece.length() > l) {
+                    return false;
+                }
+                str_copy(p, l, piece);
+                return true;
+            })) {
+            return false;
+        }
+        size -= l;
+        return true;
+    }
+
+    /**
+     * Walk a delta of diff_toDelta and hand the pieces of text2 in order to
+     * the callback, views into text1 for equalities and into the delta for
+     * insertions.  Only insertions with escapes are decoded into a scratch
+     * buffer, with the same rules as diff_fromDelta.
+     * @param text1 Source string for the diff.
+     * @param delta Delta text.
+     * @param piece Callback taking a string_view_t, returns false to stop.
+     * @return false if the delta is invalid or the callback stopped.
+     */
+private:
+    template <typename Callback>
+    inline static constexpr bool diff_walkDelta(string_view_t text1, string_view_t delta, Callback&& piece) noexcept {
+        using namespace dmp::utils;
+
+        typename container_traits::template bisect_list<char_t> scratch;
+
+        int           n       = 0;
+        size_t        tl      = text1.length();
+        size_t        pointer = 0;  // Cursor in text1
+        size_t        start   = 0;
+        size_t        len     = delta.length();
+        string_view_t token;
+        while (commons::nextLine(token, delta, start, len, char_traits::tab)) {
+
+            if (token.length() == 0) {
+                // Blank tokens are ok (from a trailing \t).
+                continue;
+            }
+            string_view_t param = token.substring(1);
+            switch (*token.begin()) {
+                case '+': {
+                    // Plain ASCII goes out as is, like percent_decode leaves it.
+                    auto   d(param.data());
+                    size_t escapes = 0;
+                    size_t pl      = param.length();
+                    for (size_t i = 0; i < pl; i++) {
+                        auto c(static_cast<std::make_unsigned_t<char_t>>(d[i]));
+                        if (c == '%') {
+                            if (i + 2 >= pl) {
+                                // Truncated escape.
+                                return false;
+                            }
+                            escapes++;
+                        } else if (c >= 0x80) {
+                            escapes++;
+                        }
+                    }
+                    if (escapes > 0) {
+                        if (pl > scratch.max_size()) {
+                            return false;
+                        }
+                        scratch.resize(pl);
+                        auto s(scratch.data());
+                        for (size_t i = 0; i < pl; i++) {
+                            s[i] = d[i];
+                        }
+                        if (!percent_decode<char_traits>(s, pl)) {
+                            return false;
+                        }
+                        param = string_view_t(s, pl);
+                    }
+                    if (!piece(param)) {
+                        return false;
+                    }
+                    break;
+                }
+                case '-':
+                    [[fallthrough]];
+                case '=':
+                    // The whole run has to be in text1, before any of it is passed on.
+                    if (!parseInt(param, n) || n < 0 || pointer >= tl || static_cast<size_t>(n) > tl - pointer) {
+                        return false;
+                    }
+                    if (*token.begin() == char_traits::cast('=') && !piece(text1.substring(pointer, static_cast<size_t>(n)))) {
+                        return false;
+                    }
+                    pointer += static_cast<size_t>(n);
+                    break;
+
+                default:
+                    // Anything else is an error.
+                    return false;
+            }
+        }
+
+        return pointer == tl;
+    }
+
+    /**
+     * Given the original text1 and a binary delta of diff_toBinaryDelta,
+     * compute the full diff.  Nothing is copied, equalities and deletions
+     * are views into text1 and insertions views into the delta.
+     * @param text1 Source string for the diff.
+     * @param delta Binary delta.
+     * @return false if the delta is invalid or doesn't match text1.
+     */
+public:
+    inline static constexpr bool diff_fromBinaryDelta(diffs_t& diffs, string_view_t text1, string_view_t delta) noexcept {
+        using delta_char_t = std::make_unsigned_t<char_t>;
+
+        diffs.clear();
+
+        auto   d(delta.data());
+        size_t len     = delta.length();
+        size_t tl      = text1.length();
+        size_t start   = 0;  // Cursor in delta
+        size_t pointer = 0;  // Cursor in text1
+        while (start < len) {
+            size_t header = 0;
+            for (size_t shift = 0;; shift += 7) {
+                if (start >= len || shift >= 8 * sizeof(size_t)) {
+                    // Truncated or overlong header.
+                    return false;
+                }
+                size_t digit = static_cast<delta_char_t>(d[start++]);
+                if (digit > 0xff) {
+                    return false;
+                }
+                header |= (digit & 0x7f) << shift;
+                if ((digit & 0x80) == 0) {
+                    break;
+                }
+            }
+
+            size_t length = header >> 2;
+            switch (header & 3) {
+                case 0:
+                case 1:
+                    if (length > tl - pointer) {
+                        // Delta longer than text1.
+                        return false;
+                    }
+                    diffs.push_back(diff_t((header & 3) == 0 ? Operation::EQUAL : Operation::DELETE, text1.substring(pointer, length)));
+                    pointer += length;
+                    break;
+                case 2:
+                    if (length > len - start) {
+                        // Truncated insertion.
+                        return false;
+                    }
+                    diffs.push_back(diff_t(Operation::INSERT, delta.substring(start, length)));
+                    start += length;
+                    break;
+                default:
+                    // Anything else is an error.
+                    return false;
+            }
+        }
+
+        // The delta must cover all of text1.
+        return pointer == tl;
+    }
 };
 }  // namespace dmp
 
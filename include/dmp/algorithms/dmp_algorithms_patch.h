@@ -95,6 +95,9 @@ struct diff_match_patch_patch {
     using diff_t  = typename commons::diff_t;
     using diffs_t = typename commons::diffs_t;
 
+    using diff_workspace = typename dmp_diff::diff_workspace;
+    using diff_offsets   = typename dmp_diff::diff_offsets;
+
     using patch_t = types::patch<diffs_t>;
     struct patches_t : public container_traits::template patches_list<patch_t> {
         using parent    = typename container_traits::template patches_list<patch_t>;
@@ -198,15 +201,31 @@ protected:
 public:
     inline static constexpr bool patch_make(const settings_t& settings, patches_t& patches, string_pool_t& pool, string_view_t text1,
                                             string_view_t text2) noexcept {
+        diff_workspace workspace;
+        return patch_make(settings, patches, pool, workspace, text1, text2);
+    }
+
+    /**
+     * Compute a list of patches to turn text1 into text2, reusing the
+     * scratch buffers of the given workspace.
+     * A set of diffs will be computed.
+     * @param workspace Scratch buffers, see diff_workspace.
+     * @param text1 Old text.
+     * @param text2 New text.
+     * @return List of Patch objects.
+     */
+public:
+    inline static constexpr bool patch_make(const settings_t& settings, patches_t& patches, string_pool_t& pool, diff_workspace& workspace,
+                                            string_view_t text1, string_view_t text2) noexcept {
         patches.clear();
 
         // Check for null inputs not needed since null can't be passed in C#.
         // No diffs provided, compute our own.
         diffs_t diffs;
-        dmp_diff::diff_main(settings, diffs, pool, text1, text2, true);
+        dmp_diff::diff_main(settings, diffs, pool, workspace, text1, text2, true);
         if (diffs.size() > 2) {
-            dmp_diff::diff_cleanupSemantic(diffs, pool);
-            dmp_diff::diff_cleanupEfficiency(settings, diffs, pool);
+            dmp_diff::diff_cleanupSemantic(diffs, pool, workspace);
+            dmp_diff::diff_cleanupEfficiency(settings, diffs, pool, workspace);
         }
         return patch_make(settings, patches, pool, text1, diffs);
     }
@@ -405,6 +424,22 @@ public:
 public:
     inline static constexpr patch_result_t patch_apply(const settings_t& settings, const patches_t& _patches, string_pool_t& pool,
                                                        string_view_t _text) noexcept {
+        diff_workspace workspace;
+        return patch_apply(settings, _patches, pool, workspace, _text);
+    }
+
+    /**
+     * Merge a set of patches onto the text, reusing the scratch buffers of
+     * the given workspace.
+     * @param patches Array of Patch objects
+     * @param workspace Scratch buffers, see diff_workspace.
+     * @param text Old text.
+     * @return Two element Object array, containing the new text and an array of
+     *      bool values.
+     */
+public:
+    inline static constexpr patch_result_t patch_apply(const settings_t& settings, const patches_t& _patches, string_pool_t& pool,
+                                                       diff_workspace& workspace, string_view_t _text) noexcept {
         if (_patches.size() == 0) {
             return { _text, {} };
         }
@@ -475,26 +510,28 @@ public:
                     // Imperfect match.  Run a diff to get a framework of equivalent
                     // indices.
                     diffs_t diffs;
-                    dmp_diff::diff_main(settings, diffs, pool, text1, text2, false);
+                    dmp_diff::diff_main(settings, diffs, pool, workspace, text1, text2, false);
                     if (text1.length() > static_cast<size_t>(settings.Match_MaxBits)
                         && static_cast<float>(commons::diff_levenshtein(diffs)) / static_cast<float>(text1.length()) > settings.Patch_DeleteThreshold) {
                         // The end points match, but the content is unacceptably bad.
                         results[static_cast<size_t>(x)] = false;
                     } else {
                         dmp_diff::diff_cleanupSemanticLossless(diffs, pool);
+                        diff_offsets offsets;
+                        dmp_diff::diff_xIndexPrepare(diffs, offsets);
 
                         size_t len = text.length();
                         size_t maxLength(len);
                         size_t index1 = 0;
                         for (auto& aDiff : aPatch.diffs) {
                             if (aDiff.operation != Operation::EQUAL) {
-                                size_t index2 = dmp_diff::diff_xIndex(diffs, index1);
+                                size_t index2 = dmp_diff::diff_xIndex(offsets, index1);
                                 if (aDiff.operation == Operation::INSERT) {
                                     // Insertion
                                     len += aDiff.text.length();
                                 } else if (aDiff.operation == Operation::DELETE) {
                                     // Deletion
-                                    len -= dmp_diff::diff_xIndex(diffs, index1 + aDiff.text.length()) - index2;
+                                    len -= dmp_diff::diff_xIndex(offsets, index1 + aDiff.text.length()) - index2;
                                 }
                                 if (len > maxLength) {
                                     maxLength = len;
@@ -520,13 +557,13 @@ public:
                         index1 = 0;
                         for (auto& aDiff : aPatch.diffs) {
                             if (aDiff.operation != Operation::EQUAL) {
-                                size_t index2 = dmp_diff::diff_xIndex(diffs, index1);
+                                size_t index2 = dmp_diff::diff_xIndex(offsets, index1);
                                 if (aDiff.operation == Operation::INSERT) {
                                     // Insertion
                                     l += str_insert(s, l, start_loc + index2, aDiff.text);
                                 } else if (aDiff.operation == Operation::DELETE) {
                                     // Deletion
-                                    l -= str_remove(s, l, start_loc + index2, dmp_diff::diff_xIndex(diffs, index1 + aDiff.text.length()) - index2);
+                                    l -= str_remove(s, l, start_loc + index2, dmp_diff::diff_xIndex(offsets, index1 + aDiff.text.length()) - index2);
                                 }
                             }
                             if (aDiff.operation != Operation::DELETE) {
@@ -58,11 +58,16 @@ int main(int argc, char **argv) {
 #include "dmp/types/dmp_container.h"
 
 #include <memory>
+#include <type_traits>
+#include <vector>
 
 namespace dmp {
 
 namespace utils {
 
+// Opt-in, the overloads taking mapped files need dmp/utils/dmp_mappedfile.h.
+class mapped_file;
+
 template <typename elements_t, typename string_pool_t>
 struct container : public types::container_base<elements_t, std::unique_ptr<elements_t>> {
     using parent = types::container_base<elements_t, std::unique_ptr<elements_t>>;
@@ -73,10 +78,14 @@ struct container : public types::container_base<elements_t, std::unique_ptr<elem
 
     mutable string_pool_t stringPool;
 
+    // Owners of texts the elements point into, e.g. mapped files.
+    std::vector<std::shared_ptr<const void>> keepAlive;
+
 
     inline container() noexcept
         : parent(std::make_unique<elements_t>())
-        , stringPool() {}
+        , stringPool()
+        , keepAlive() {}
 
 
     container(container&&) noexcept = default;
@@ -91,11 +100,13 @@ struct container : public types::container_base<elements_t, std::unique_ptr<elem
     inline constexpr void clear() noexcept {
         parent::clear();
         stringPool.clear();
+        keepAlive.clear();
     }
 
     inline constexpr void reset() noexcept {
         parent::clear();
         stringPool.clear();
+        keepAlive.clear();
     }
 };
 
@@ -126,16 +137,27 @@ struct diff_match_patch : public dmp::types::settings, public dmp::diff_match_pa
 
     using string_view_t   = typename parent::string_view_t;
     using owning_string_t = typename parent::owning_string_t;
+    using char_t          = typename commons::char_t;
     using stringstream_t  = typename all_traits::string_traits::stringstream_t;
     using clock_t         = typename parent::clock_t;
 
     using diffs_t = typename parent::diffs_t;
     using Diffs   = utils::container<diffs_t, string_pool_t>;
 
+    using diff_workspace = typename parent::diff_workspace;
+    using diff_offsets   = typename parent::diff_offsets;
+    using diff_sketch    = typename parent::diff_sketch;
+
     using patches_t = typename parent::patches_t;
     using Patches   = utils::container<patches_t, string_pool_t>;
 
+    // Dependent on the traits, so that utils::mapped_file is only needed
+    // when the mapped file overloads are used.
+    using MappedFile = std::shared_ptr<const std::conditional_t<sizeof(all_traits) != 0, utils::mapped_file, void>>;
+
     using Operation      = typename parent::Operation;
+    using Cleanup        = typename parent::Cleanup;
+    using LineDiff       = typename parent::LineDiff;
     using Diff           = typename parent::diff_t;
     using Patch          = typename parent::patch_t;
     using patch_result_t = typename parent::patch_result_t;
@@ -237,6 +259,170 @@ public:
     }
 
 
+    /**
+     * Find the differences between two texts, reusing the scratch buffers
+     * of the given workspace.
+     * @param workspace Scratch buffers, see diff_workspace.
+     * @param text1 Old string to be diffed.
+     * @param text2 New string to be diffed.
+     * @param checklines Speedup flag.  If false, then don't run a
+     *     line-level diff first to identify the changed areas.
+     *     If true, then run a faster slightly less optimal diff.
+     * @return List of Diff objects.
+     */
+public:
+    inline constexpr Diffs diff_main(diff_workspace& workspace, string_view_t text1, string_view_t text2, bool checklines = true) const noexcept {
+        Diffs container;
+
+        using original_texts = typename string_pool_t::original_texts;
+        original_texts texts[] { &text1, &text2 };
+
+        container.stringPool.setOriginalTexts(texts);
+
+        container.null = false;
+        parent::diff_main(*this, *container.elements, container.stringPool, workspace, text1, text2, checklines);
+        container.stringPool.resetOriginalTexts();
+        return container;
+    }
+
+
+    /**
+     * Find the differences between two texts if they are at most maxEdits
+     * inserted or deleted characters apart, see diff_main_bounded in the diff
+     * algorithms.
+     * @param diffs Receives the diffs, the same as of diff_main.
+     * @param text1 Old string to be diffed.
+     * @param text2 New string to be diffed.
+     * @param maxEdits Maximum number of edits.
+     * @return false if the texts are more than maxEdits edits apart, diffs is
+     *     empty then.
+     */
+public:
+    using parent::diff_main_bounded;
+    inline constexpr bool diff_main_bounded(Diffs& diffs, string_view_t text1, string_view_t text2, size_t maxEdits) const noexcept {
+        diff_workspace workspace;
+        return diff_main_bounded(workspace, diffs, text1, text2, maxEdits);
+    }
+    inline constexpr bool diff_main_bounded(diff_workspace& workspace, Diffs& diffs, string_view_t text1, string_view_t text2,
+                                            size_t maxEdits) const noexcept {
+        using original_texts = typename string_pool_t::original_texts;
+        original_texts texts[] { &text1, &text2 };
+
+        diffs.stringPool.setOriginalTexts(texts);
+
+        diffs.null  = false;
+        bool result = parent::diff_main_bounded(*this, *diffs.elements, diffs.stringPool, workspace, text1, text2, maxEdits);
+        diffs.stringPool.resetOriginalTexts();
+        return result;
+    }
+
+
+    /**
+     * Find the differences between two memory mapped files.  The diffs point
+     * into the mappings, which are kept alive by the returned container.
+     * @param file1 Old file to be diffed, see utils::mapped_file::open.
+     * @param file2 New file to be diffed.
+     * @param checklines Speedup flag, see diff_main.
+     * @return List of Diff objects, null if a file isn't mapped.
+     */
+public:
+    inline Diffs diff_main(const MappedFile& file1, const MappedFile& file2, bool checklines = true) const noexcept {
+        if (!file1 || !file2) {
+            Diffs container;
+            container.null = true;
+            return container;
+        }
+
+        Diffs container(diff_main(file1->template text<string_view_t>(), file2->template text<string_view_t>(), checklines));
+        container.keepAlive.push_back(file1);
+        container.keepAlive.push_back(file2);
+        return container;
+    }
+
+
+    /**
+     * Find the differences between two texts token by token, e.g. word by
+     * word.  All diffs are views into text1 or text2.
+     * @param text1 Old string to be diffed.
+     * @param text2 New string to be diffed.
+     * @param tokenizer Tokenizer policy, e.g. types::word_tokenizer,
+     *     types::whitespace_tokenizer or any callable with the same signature.
+     * @return List of Diff objects.
+     */
+public:
+    template <typename tokenizer_t = types::word_tokenizer>
+    inline constexpr Diffs diff_tokens(string_view_t text1, string_view_t text2, const tokenizer_t& tokenizer = tokenizer_t {}) const noexcept {
+        Diffs          container;
+        diff_workspace workspace;
+
+        using original_texts = typename string_pool_t::original_texts;
+        original_texts texts[] { &text1, &text2 };
+
+        container.stringPool.setOriginalTexts(texts);
+
+        container.null = false;
+        parent::diff_tokenMode(*this, *container.elements, container.stringPool, workspace, text1, text2, tokenizer);
+        container.stringPool.resetOriginalTexts();
+        return container;
+    }
+
+    /**
+     * Update the diffs of text1 and text2 after text2 has been edited, e.g.
+     * by a keystroke in an editor.  Only the diffs around the edit are
+     * computed again, see diff_rediff in the diff algorithms, but the cost
+     * still grows with the number of diffs.  Afterwards the diffs view text1
+     * and text2, which must outlive them, and the strings of their pool are
+     * released.
+     * @param diffs Diffs of text1 and text2 before the edit, updated in place.
+     * @param text1 Old string, unchanged by the edit.
+     * @param text2 New string, text2 after the edit.
+     * @param offset Position of the edit in text2 before the edit.
+     * @param removedLength Number of characters removed at offset.
+     * @param insertedLength Number of characters inserted at offset.
+     * @return false if the edit doesn't match the diffs, which are unchanged.
+     */
+public:
+    using parent::diff_rediff;
+    inline constexpr bool diff_rediff(Diffs& diffs, string_view_t text1, string_view_t text2, size_t offset, size_t removedLength,
+                                      size_t insertedLength) const noexcept {
+        diff_workspace workspace;
+        return diff_rediff(workspace, diffs, text1, text2, offset, removedLength, insertedLength);
+    }
+    inline constexpr bool diff_rediff(diff_workspace& workspace, Diffs& diffs, string_view_t text1, string_view_t text2, size_t offset,
+                                      size_t removedLength, size_t insertedLength) const noexcept {
+        using original_texts = typename string_pool_t::original_texts;
+        original_texts texts[] { &text1, &text2 };
+
+        diffs.stringPool.setOriginalTexts(texts);
+
+        bool result = parent::diff_rediff(*this, *diffs.elements, diffs.stringPool, workspace, text1, text2, offset, removedLength, insertedLength);
+        diffs.stringPool.resetOriginalTexts();
+        if (result) {
+            // No diff views a string of the pool anymore.
+            diffs.stringPool.clear();
+        }
+        return result;
+    }
+
+
+    /**
+     * Run several cleanups in the order diff_cleanupMerge,
+     * diff_cleanupSemantic or diff_cleanupSemanticLossless, and
+     * diff_cleanupEfficiency.
+     * @param diffs List of Diff objects.
+     * @param cleanups The cleanups to run, e.g. Cleanup::SEMANTIC | Cleanup::EFFICIENCY.
+     */
+public:
+    using parent::diff_cleanup;
+    inline constexpr void diff_cleanup(Diffs& diffs, Cleanup cleanups) const noexcept {
+        diff_workspace workspace;
+        parent::diff_cleanup(*this, *diffs.elements, diffs.stringPool, workspace, cleanups);
+    }
+    inline constexpr void diff_cleanup(diff_workspace& workspace, Diffs& diffs, Cleanup cleanups) const noexcept {
+        parent::diff_cleanup(*this, *diffs.elements, diffs.stringPool, workspace, cleanups);
+    }
+
+
     /**
      * Reduce the number of edits by eliminating semantically trivial
      * equalities.
@@ -245,6 +431,9 @@ public:
 public:
     using parent::diff_cleanupSemantic;
     inline constexpr void diff_cleanupSemantic(Diffs& diffs) const noexcept { parent::diff_cleanupSemantic(*diffs.elements, diffs.stringPool); }
+    inline constexpr void diff_cleanupSemantic(diff_workspace& workspace, Diffs& diffs) const noexcept {
+        parent::diff_cleanupSemantic(*diffs.elements, diffs.stringPool, workspace);
+    }
 
 
     /**
@@ -257,37 +446,76 @@ public:
     inline constexpr void diff_cleanupEfficiency(Diffs& diffs) const noexcept {
         parent::diff_cleanupEfficiency(*this, *diffs.elements, diffs.stringPool);
     }
+    inline constexpr void diff_cleanupEfficiency(diff_workspace& workspace, Diffs& diffs) const noexcept {
+        parent::diff_cleanupEfficiency(*this, *diffs.elements, diffs.stringPool, workspace);
+    }
+
+
+    /**
+     * Count the hunks of a diff, runs of changes with the equality that
+     * follows them.
+     * @param diffs List of Diff objects.
+     * @return Number of hunks.
+     */
+public:
+    inline constexpr size_t diff_hunkCount(const Diffs& diffs) const noexcept { return commons::diff_hunkCount(*diffs.elements); }
+    inline constexpr size_t diff_hunkCount(const diffs_t& diffs) const noexcept { return commons::diff_hunkCount(diffs); }
 
 
     /**
      * Convert a Diff list into a pretty HTML report.
      * @param diffs List of Diff objects.
+     * @param firstHunk First hunk to render, see diff_hunkCount.
+     * @param hunkCount Number of hunks to render.
      * @return HTML representation.
      */
 public:
-    inline constexpr owning_string_t diff_prettyHtml(const Diffs& diffs) const noexcept {
+    inline constexpr owning_string_t diff_prettyHtml(const Diffs& diffs, size_t firstHunk = 0, size_t hunkCount = npos) const noexcept {
         stringstream_t s;
-        commons::diff_prettyHtml(s, *diffs.elements);
+        commons::diff_prettyHtml(s, *diffs.elements, firstHunk, hunkCount);
         return s.str();
     }
-    inline constexpr owning_string_t diff_prettyHtml(const diffs_t& diffs) const noexcept {
+    inline constexpr owning_string_t diff_prettyHtml(const diffs_t& diffs, size_t firstHunk = 0, size_t hunkCount = npos) const noexcept {
         stringstream_t s;
-        commons::diff_prettyHtml(s, diffs);
+        commons::diff_prettyHtml(s, diffs, firstHunk, hunkCount);
         return s.str();
     }
 
     template <typename Stream>
-    inline constexpr Stream& diff_prettyHtml(Stream& s, const Diffs& diffs) const noexcept {
-        commons::diff_prettyHtml(s, *diffs.elements);
+    inline constexpr Stream& diff_prettyHtml(Stream& s, const Diffs& diffs, size_t firstHunk = 0, size_t hunkCount = npos) const noexcept {
+        commons::diff_prettyHtml(s, *diffs.elements, firstHunk, hunkCount);
         return s;
     }
 
     template <typename Stream>
-    inline constexpr Stream& diff_prettyHtml(Stream& s, const diffs_t& diffs) const noexcept {
-        commons::diff_prettyHtml(s, diffs);
+    inline constexpr Stream& diff_prettyHtml(Stream& s, const diffs_t& diffs, size_t firstHunk = 0, size_t hunkCount = npos) const noexcept {
+        commons::diff_prettyHtml(s, diffs, firstHunk, hunkCount);
         return s;
     }
 
+    inline constexpr bool diff_prettyHtml(char_t* buffer, size_t& size, const Diffs& diffs, size_t firstHunk = 0, size_t hunkCount = npos) const noexcept {
+        return commons::diff_prettyHtml(buffer, size, *diffs.elements, firstHunk, hunkCount);
+    }
+    inline constexpr bool diff_prettyHtml(char_t* buffer, size_t& size, const diffs_t& diffs, size_t firstHunk = 0, size_t hunkCount = npos) const noexcept {
+        return commons::diff_prettyHtml(buffer, size, diffs, firstHunk, hunkCount);
+    }
+
+
+    /**
+     * Compute the length of the pretty HTML report without building it.
+     * @param diffs List of Diff objects.
+     * @param firstHunk First hunk to render, see diff_hunkCount.
+     * @param hunkCount Number of hunks to render.
+     * @return Length of the HTML representation.
+     */
+public:
+    inline constexpr size_t diff_prettyHtmlLength(const Diffs& diffs, size_t firstHunk = 0, size_t hunkCount = npos) const noexcept {
+        return commons::diff_prettyHtmlLength(*diffs.elements, firstHunk, hunkCount);
+    }
+    inline constexpr size_t diff_prettyHtmlLength(const diffs_t& diffs, size_t firstHunk = 0, size_t hunkCount = npos) const noexcept {
+        return commons::diff_prettyHtmlLength(diffs, firstHunk, hunkCount);
+    }
+
 
     /**
      * Crush the diff into an encoded string which describes the operations
@@ -310,6 +538,54 @@ public:
         return s.str();
     }
 
+    /**
+     * Crush the diff into a binary delta, see diff_toBinaryDelta in the
+     * common algorithms.
+     * @param diffs Array of Diff objects.
+     * @return Binary delta.
+     */
+public:
+    inline constexpr owning_string_t diff_toBinaryDelta(const Diffs& diffs) const noexcept {
+        stringstream_t s;
+        commons::diff_toBinaryDelta(s, *diffs.elements);
+        return s.str();
+    }
+    inline constexpr owning_string_t diff_toBinaryDelta(const diffs_t& diffs) const noexcept {
+        stringstream_t s;
+        commons::diff_toBinaryDelta(s, diffs);
+        return s.str();
+    }
+
+    /**
+     * Write the diff in the unified format of GNU diff, see diff_toUnified
+     * in the common algorithms.
+     * @param diffs Array of Diff objects.
+     * @param fromFile Name of text1 for the --- line.
+     * @param toFile Name of text2 for the +++ line.
+     * @param contextLines Number of equal lines around each change.
+     * @return Unified diff.
+     */
+public:
+    inline constexpr owning_string_t diff_toUnified(const Diffs& diffs, string_view_t fromFile, string_view_t toFile, size_t contextLines = 3) const noexcept {
+        stringstream_t s;
+        commons::diff_toUnified(s, *diffs.elements, fromFile, toFile, contextLines);
+        return s.str();
+    }
+    inline constexpr owning_string_t diff_toUnified(const diffs_t& diffs, string_view_t fromFile, string_view_t toFile, size_t contextLines = 3) const noexcept {
+        stringstream_t s;
+        commons::diff_toUnified(s, diffs, fromFile, toFile, contextLines);
+        return s.str();
+    }
+
+    template <typename Stream>
+    inline constexpr Stream& diff_toUnified(Stream& s, const Diffs& diffs, string_view_t fromFile, string_view_t toFile, size_t contextLines = 3) const noexcept {
+        return commons::diff_toUnified(s, *diffs.elements, fromFile, toFile, contextLines);
+    }
+    template <typename Stream>
+    inline constexpr Stream& diff_toUnified(Stream& s, const diffs_t& diffs, string_view_t fromFile, string_view_t toFile, size_t contextLines = 3) const noexcept {
+        return commons::diff_toUnified(s, diffs, fromFile, toFile, contextLines);
+    }
+
     /**
      * Given the original text1, and an encoded string which describes the
      * operations required to transform text1 into text2, compute the full diff.
@@ -334,6 +610,21 @@ public:
         return container;
     }
 
+    /**
+     * Given the original text1 and a binary delta, compute the full diff.
+     * The diffs are views into text1 and the delta, which must outlive them.
+     * @param text1 Source string for the diff.
+     * @param delta Binary delta.
+     * @return Array of Diff objects or null if invalid.
+     */
+public:
+    using parent::diff_fromBinaryDelta;
+    inline constexpr Diffs diff_fromBinaryDelta(string_view_t text1, string_view_t delta) const noexcept {
+        Diffs container;
+        container.null = !parent::diff_fromBinaryDelta(*container.elements, text1, delta);
+        return container;
+    }
+
 
     /**
      * Compute and return the source text (all equalities and deletions).
@@ -466,6 +757,41 @@ public:
         container.stringPool.resetOriginalTexts();
         return container;
     }
+    inline constexpr Patches patch_make(diff_workspace& workspace, string_view_t text1, string_view_t text2) const noexcept {
+        Patches container;
+
+        using original_texts = typename string_pool_t::original_texts;
+        original_texts texts[] { &text1, &text2 };
+
+        container.stringPool.setOriginalTexts(texts);
+
+        container.null = false;
+        parent::patch_make(static_cast<const settings_t&>(*this), *container.elements, container.stringPool, workspace, text1, text2);
+        container.stringPool.resetOriginalTexts();
+        return container;
+    }
+
+    /**
+     * Compute a list of patches to turn the content of file1 into file2.  The
+     * patches point into the mappings, which are kept alive by the returned
+     * container.
+     * @param file1 Old file, see utils::mapped_file::open.
+     * @param file2 New file.
+     * @return List of Patch objects, null if a file isn't mapped.
+     */
+public:
+    inline Patches patch_make(const MappedFile& file1, const MappedFile& file2) const noexcept {
+        if (!file1 || !file2) {
+            Patches container;
+            container.null = true;
+            return container;
+        }
+
+        Patches container(patch_make(file1->template text<string_view_t>(), file2->template text<string_view_t>()));
+        container.keepAlive.push_back(file1);
+        container.keepAlive.push_back(file2);
+        return container;
+    }
 
     /**
      * Compute a list of patches to turn text1 into text2.
@@ -530,6 +856,21 @@ public:
     inline constexpr PatchResult patch_apply(const Patches& patches, string_view_t text) const noexcept {
         return PatchResult { parent::patch_apply(*this, *patches.elements, patches.stringPool, text) };
     }
+    inline constexpr PatchResult patch_apply(diff_workspace& workspace, const Patches& patches, string_view_t text) const noexcept {
+        return PatchResult { parent::patch_apply(*this, *patches.elements, patches.stringPool, workspace, text) };
+    }
+
+    /**
+     * Merge a set of patches onto the content of a memory mapped file.
+     * @param patches Array of Patch objects
+     * @param file Old file, see utils::mapped_file::open.  A null file is
+     *     taken as an empty text.
+     * @return The new text and which patches were applied, like patch_apply.
+     */
+public:
+    inline PatchResult patch_apply(const Patches& patches, const MappedFile& file) const noexcept {
+        return patch_apply(patches, file ? file->template text<string_view_t>() : string_view_t {});
+    }
 };
 
 }  // namespace dmp
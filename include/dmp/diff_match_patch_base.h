@@ -81,9 +81,15 @@ struct diff_match_patch_base : public diff_match_patch_diff<all_traits>,
 
 
     using Operation = typename algorithm_diff::Operation;
+    using Cleanup   = typename algorithm_diff::Cleanup;
+    using LineDiff  = typename algorithm_diff::LineDiff;
     using diff_t    = typename algorithm_diff::diff_t;
     using diffs_t   = typename algorithm_diff::diffs_t;
 
+    using diff_workspace = typename algorithm_diff::diff_workspace;
+    using diff_offsets   = typename algorithm_diff::diff_offsets;
+    using diff_sketch    = typename algorithm_diff::diff_sketch;
+
     using patch_t        = typename algorithm_patch::patch_t;
     using patches_t      = typename algorithm_patch::patches_t;
     using patch_result_t = typename algorithm_patch::patch_result_t;
@@ -0,0 +1,285 @@
+/*
+ * Diff Match and Patch
+ * Copyright 2020 The diff-match-patch Authors.
+ * https://github.com/google/diff-match-patch
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * Functions for diff, match and patch.
+ * Computes the difference between two texts to create a patch.
+ * Applies the patch onto another text, allowing for errors.
+ *
+ * @author fraser@google.com (Neil Fraser)
+ *
+ * STL-only port by snhere@gmail.com (Sergey Nozhenko)
+ * and some tweaks for std::string by leutloff@sundancer.oche.de (Christian Leutloff)
+ * rebased on the current C# version and added constexpr-ness by guntersp0@gmail.com (Gunter Spöcker):
+ *
+ * Here is a trivial sample program:
+
+#include "diff_match_patch.h"
+#include <string>
+using namespace std;
+int main(int argc, char **argv) {
+    diff_match_patch<all_traits<std_wstring_traits, chrono_clock_traits, std_container_traits>> dmp;
+
+    wstring str1 = L"First string in diff";
+    wstring str2 = L"Second string in diff";
+
+    wstring strPatch = dmp.patch_toText(dmp.patch_make(str1, str2));
+    auto    out(dmp.patch_apply(dmp.patch_fromText(strPatch), str1));
+    wstring strResult(out.text2);
+
+    // here, strResult will equal str2 above.
+    std::wcout << strResult << "\n";
+    return 0;
+}
+*/
+
+
+#ifndef DIFF_MATCH_PATCH_STREAM_H
+#define DIFF_MATCH_PATCH_STREAM_H
+
+
+#include "dmp/diff_match_patch_base.h"
+
+#include <algorithm>
+
+namespace dmp {
+
+/**
+ * Session which diffs two texts given chunk by chunk, e.g. while reading
+ * two large files.  The chunks are buffered and diffed window by window,
+ * the diffs up to the last long equality of a window are settled and
+ * passed to a sink, the rest is kept and diffed again with the next window.
+ * As long as chunks of both texts are appended alternately, no more than
+ * about Stream_Window characters of each text are buffered.
+ *
+ * The settled diffs always form a diff of the settled parts of both texts,
+ * so all diffs passed to the sink form a diff of the whole texts.  Settled
+ * diffs never reach the end of a window before the end of the texts, the
+ * characters there are always diffed again together with the following
+ * chunks.  The diffs may still differ from a diff of the whole texts, since
+ * the session assumes that the settling equality is kept.
+ * With non-allocating string traits the owning strings have a fixed
+ * capacity, which has to hold about two windows of a text.
+ *
+ * A sink is any callable taking a diff, e.g.
+ *   [](const Diff& diff) { ... }
+ * The text of a diff is only valid during the call.  Subsequent diffs
+ * with the same operation are not merged across windows.
+ */
+template <class all_traits>
+struct diff_match_patch_stream : public dmp::types::settings {
+    using algorithm_diff = diff_match_patch_diff<all_traits>;
+
+    using string_pool_t = typename algorithm_diff::string_pool_t;
+
+    using string_view_t   = typename algorithm_diff::string_view_t;
+    using owning_string_t = typename algorithm_diff::owning_string_t;
+
+    using Operation = typename algorithm_diff::Operation;
+    using Diff      = typename algorithm_diff::diff_t;
+    using diffs_t   = typename algorithm_diff::diffs_t;
+
+    using diff_workspace = typename algorithm_diff::diff_workspace;
+
+    // Number of characters of each text diffed at a time.
+    size_t Stream_Window = 65536;
+
+    // Minimum length of an equality which settles the diffs before it.
+    size_t Stream_Anchor = 32;
+
+private:
+    owning_string_t buffer1 {};
+    owning_string_t buffer2 {};
+    size_t          start1 = 0;
+    size_t          start2 = 0;
+
+    diffs_t        diffs {};
+    string_pool_t  pool { nullptr, 0 };
+    diff_workspace workspace {};
+
+public:
+    inline diff_match_patch_stream() noexcept {}
+
+    /**
+     * Append a chunk of the old text.
+     * @param chunk Next part of text1, copied into the session.
+     */
+    inline void append1(string_view_t chunk) noexcept { append(buffer1, start1, chunk); }
+
+    /**
+     * Append a chunk of the new text.
+     * @param chunk Next part of text2, copied into the session.
+     */
+    inline void append2(string_view_t chunk) noexcept { append(buffer2, start2, chunk); }
+
+    /**
+     * Number of buffered characters of both texts, which are not settled yet.
+     */
+    inline size_t bufferedLength() const noexcept { return buffer1.length() - start1 + buffer2.length() - start2; }
+
+    /**
+     * Diff all full windows of the buffered texts and pass the settled diffs
+     * to the sink.
+     * @param sink Callable taking a Diff.
+     */
+    template <typename sink_t>
+    inline void flush(sink_t&& sink) noexcept {
+        while (buffer1.length() - start1 >= Stream_Window && buffer2.length() - start2 >= Stream_Window) {
+            settle(sink, false);
+        }
+    }
+
+    /**
+     * Diff the rest of the texts, after their last chunks were appended, and
+     * pass all remaining diffs to the sink.  The session can be used for the
+     * next pair of texts afterwards.
+     * @param sink Callable taking a Diff.
+     */
+    template <typename sink_t>
+    inline void finish(sink_t&& sink) noexcept {
+        flush(sink);
+        while (start1 < buffer1.length() || start2 < buffer2.length()) {
+            settle(sink, true);
+        }
+        buffer1.clear();
+        buffer2.clear();
+        start1 = 0;
+        start2 = 0;
+    }
+
+private:
+    inline static void append(owning_string_t& buffer, size_t& start, string_view_t chunk) noexcept {
+        using namespace dmp::utils;
+
+        // Drop the settled part before the buffer would grow.
+        if (start > 0 && start * 2 >= buffer.length()) {
+            auto   data(get_data(buffer));
+            size_t length(get_length(buffer));
+            for (size_t i = start; i < length; i++) {
+                data[i - start] = data[i];
+            }
+            str_resize(buffer, length - start);
+            start = 0;
+        }
+        str_append(buffer, chunk);
+    }
+
+    /**
+     * Diff the next window of both texts and pass the diffs up to the last
+     * long equality to the sink, or all of them for the last window.
+     * Without such an equality only the first half of the window is settled.
+     */
+    template <typename sink_t>
+    inline void settle(sink_t& sink, bool last) noexcept {
+        string_view_t text1 { buffer1 };
+        string_view_t text2 { buffer2 };
+        text1 = text1.substring(start1, (std::min)(text1.length() - start1, Stream_Window));
+        text2 = text2.substring(start2, (std::min)(text2.length() - start2, Stream_Window));
+        last  = last && start1 + text1.length() == buffer1.length() && start2 + text2.length() == buffer2.length();
+
+        using original_texts = typename string_pool_t::original_texts;
+        original_texts texts[] { &text1, &text2 };
+        pool.setOriginalTexts(texts);
+
+        diffs.clear();
+        algorithm_diff::diff_main(*this, diffs, pool, workspace, text1, text2, true);
+
+        if (last) {
+            for (auto& diff : diffs) {
+                emit(sink, diff);
+            }
+        } else {
+            // The diffs after the settling equality may still change with the
+            // text of the next window.  Diffs start with the common prefix, so a
+            // leading equality is settled too.  The settling equality has to end
+            // before the end of both windows, otherwise the next chunks could
+            // extend it.
+            size_t anchor = 0;
+            size_t end1   = text1.length();
+            size_t end2   = text2.length();
+            for (size_t i = diffs.size(); i-- > 0;) {
+                const Diff& diff(diffs[i]);
+                if (diff.operation == Operation::EQUAL && end1 < text1.length() && end2 < text2.length()
+                    && (i == 0 || diff.text.length() >= Stream_Anchor)) {
+                    anchor = i + 1;
+                    break;
+                }
+                if (diff.operation != Operation::INSERT) {
+                    end1 -= diff.text.length();
+                }
+                if (diff.operation != Operation::DELETE) {
+                    end2 -= diff.text.length();
+                }
+            }
+
+            if (anchor > 0) {
+                for (size_t i = 0; i < anchor; i++) {
+                    emit(sink, diffs[i]);
+                }
+            } else {
+                // Without an anchor the second half of the window stays
+                // buffered, the diff crossing the middle is cut there.
+                size_t half     = (std::max)(Stream_Window / 2, size_t { 1 });
+                size_t settled1 = 0;
+                size_t settled2 = 0;
+                for (auto& diff : diffs) {
+                    size_t length = diff.text.length();
+                    if (diff.operation != Operation::INSERT) {
+                        length = (std::min)(length, half - settled1);
+                    }
+                    if (diff.operation != Operation::DELETE) {
+                        length = (std::min)(length, half - settled2);
+                    }
+                    if (length == 0) {
+                        break;
+                    }
+                    emit(sink, Diff(diff.operation, diff.text.substring(0, length)));
+                    if (diff.operation != Operation::INSERT) {
+                        settled1 += length;
+                    }
+                    if (diff.operation != Operation::DELETE) {
+                        settled2 += length;
+                    }
+                    if (length < diff.text.length()) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        diffs.clear();
+        pool.clear();
+        pool.resetOriginalTexts();
+    }
+
+    template <typename sink_t>
+    inline void emit(sink_t& sink, const Diff& diff) noexcept {
+        if (diff.operation != Operation::INSERT) {
+            start1 += diff.text.length();
+        }
+        if (diff.operation != Operation::DELETE) {
+            start2 += diff.text.length();
+        }
+        sink(diff);
+    }
+};
+
+}  // namespace dmp
+
+#endif
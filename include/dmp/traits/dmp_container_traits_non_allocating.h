@@ -77,6 +77,9 @@ int main(int argc, char **argv) {
 #ifndef NON_ALLOCATING_MAX_STRINGPOOL_LIST_SIZE
 #    define NON_ALLOCATING_MAX_STRINGPOOL_LIST_SIZE 384
 #endif
+#ifndef TEMP_NON_ALLOCATING_MAX_ENCODING_STRINGPOOL_LIST_SIZE
+#    define TEMP_NON_ALLOCATING_MAX_ENCODING_STRINGPOOL_LIST_SIZE 8
+#endif
 #ifndef TEMP_NON_ALLOCATING_MAX_LINE_ENCODING_LIST_SIZE
 #    define TEMP_NON_ALLOCATING_MAX_LINE_ENCODING_LIST_SIZE 512
 #endif
@@ -102,6 +105,12 @@ struct container_traits<NonAllocatingContainers> {
         inline constexpr value& insertAndReturnValue(const key& k, value v) noexcept { return this->emplace(k, v).first->second; }
     };
 
+    // The line count is bounded by the encoding list, so a linear scan will do.
+    template <typename key, typename value>
+    struct line_hash : public utils::small_map<key, value, TEMP_NON_ALLOCATING_MAX_LINE_ENCODING_LIST_SIZE> {
+        inline constexpr value& insertAndReturnValue(const key& k, value v) noexcept { return this->emplace(k, v).first->second; }
+    };
+
     template <typename key, typename value>
     struct alphabet_hash : public utils::small_map<key, value, 256> {
         inline constexpr value& insertAndReturnValue(const key& k, value v) noexcept { return this->emplace(k, v).first->second; }
@@ -131,6 +140,10 @@ struct container_traits<NonAllocatingContainers> {
     template <typename type>
     using string_pool_list = utils::small_vector<type, NON_ALLOCATING_MAX_STRINGPOOL_LIST_SIZE>;
 
+    // The line encoded diffs join few strings, the encoded strings are large.
+    template <typename type>
+    using encoding_string_pool_list = utils::small_vector<type, TEMP_NON_ALLOCATING_MAX_ENCODING_STRINGPOOL_LIST_SIZE>;
+
     template <typename type>
     using encoding_list = utils::small_vector<type, TEMP_NON_ALLOCATING_MAX_LINE_ENCODING_LIST_SIZE>;
 
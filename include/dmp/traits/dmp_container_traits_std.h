@@ -54,6 +54,7 @@ int main(int argc, char **argv) {
 #define DIFF_MATCH_PATCH_CONTAINERTRAITS_STD_H
 
 
+#include "dmp/utils/dmp_linehash.h"
 #include "dmp/utils/dmp_traits.h"
 #include "dmp/utils/dmp_utils.h"
 
@@ -90,6 +91,9 @@ struct container_traits<StdContainers> {
     template <typename type>
     using basic_list = std::vector<type>;
 
+    template <typename key, typename value>
+    using line_hash = utils::line_hash<key, value, basic_list>;
+
     template <typename type>
     struct diffs_list : public basic_list<type> {
         using parent = basic_list<type>;
@@ -169,6 +173,9 @@ struct container_traits<StdContainers> {
     template <typename type>
     using string_pool_list = diffs_list<type>;
 
+    template <typename type>
+    using encoding_string_pool_list = diffs_list<type>;
+
     template <typename type>
     using encoding_list = diffs_list<type>;
 
@@ -84,6 +84,7 @@ struct default_char_traits {
     inline static constexpr bool isDigit(char_t c) { return utils::isDigit(c); }
     inline static constexpr bool isSpace(char_t c) { return utils::isSpace(c); }
     inline static constexpr bool isControl(char_t c) { return utils::isControl(c); }
+    inline static constexpr uint8_t charClass(char_t c) { return utils::charClass(c); }
 
     template <typename any_char_t>
     inline static constexpr char_t cast(any_char_t c) {
@@ -110,8 +110,9 @@ struct encoded_string_traits {
     static constexpr const size_t npos = static_cast<size_t>(-1);
 
 
-    template <typename string_view_t, typename owning_string_t, template <typename> class list_t>
-    using string_pool_t = _string_pool_t<string_view_t, owning_string_t, list_t>;
+    // The pool of the encoded diff has a list of its own.
+    template <typename string_view_t, typename owning_string_t, template <typename> class /*list_t*/>
+    using string_pool_t = _string_pool_t<string_view_t, owning_string_t, container_traits::template encoding_string_pool_list>;
 };
 
 
@@ -126,8 +127,8 @@ struct diff_encoding_helper {
     using encoding_string_traits
         = encoded_string_traits<typename algorithm_diff::string_traits::encoding_char_t, typename algorithm_diff::container_traits, string_pool_t>;
 
-    using encoding_all_traits
-        = dmp::all_traits<encoding_string_traits, typename algorithm_diff::clock_traits, typename algorithm_diff::container_traits>;
+    using encoding_all_traits = dmp::all_traits<encoding_string_traits, typename algorithm_diff::clock_traits, typename algorithm_diff::container_traits,
+                                                typename algorithm_diff::executor_traits>;
 
     using algorithm_diff_t = dmp::diff_match_patch_diff<encoding_all_traits>;
 };
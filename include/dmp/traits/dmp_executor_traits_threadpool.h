@@ -0,0 +1,97 @@
+/*
+ * Diff Match and Patch
+ * Copyright 2020 The diff-match-patch Authors.
+ * https://github.com/google/diff-match-patch
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * Functions for diff, match and patch.
+ * Computes the difference between two texts to create a patch.
+ * Applies the patch onto another text, allowing for errors.
+ *
+ * @author fraser@google.com (Neil Fraser)
+ *
+ * STL-only port by snhere@gmail.com (Sergey Nozhenko)
+ * and some tweaks for std::string by leutloff@sundancer.oche.de (Christian Leutloff)
+ * rebased on the current C# version and added constexpr-ness by guntersp0@gmail.com (Gunter Spöcker):
+ *
+ * Here is a trivial sample program:
+
+#include "diff_match_patch.h"
+#include <string>
+using namespace std;
+int main(int argc, char **argv) {
+    diff_match_patch<all_traits<std_wstring_traits, chrono_clock_traits, std_container_traits>> dmp;
+
+    wstring str1 = L"First string in diff";
+    wstring str2 = L"Second string in diff";
+
+    wstring strPatch = dmp.patch_toText(dmp.patch_make(str1, str2));
+    auto    out(dmp.patch_apply(dmp.patch_fromText(strPatch), str1));
+    wstring strResult(out.text2);
+
+    // here, strResult will equal str2 above.
+    std::wcout << strResult << "\n";
+    return 0;
+}
+*/
+
+
+#ifndef DIFF_MATCH_PATCH_EXECUTORTRAITS_THREADPOOL_H
+#define DIFF_MATCH_PATCH_EXECUTORTRAITS_THREADPOOL_H
+
+
+#include "dmp/utils/dmp_threadpool.h"
+#include "dmp/utils/dmp_traits.h"
+
+namespace dmp {
+namespace traits {
+
+struct ThreadPoolExecutor;
+
+template <>
+struct executor_traits<ThreadPoolExecutor> {
+    // Independent sub diffs above Diff_ParallelThreshold are forked onto the pool.
+    static constexpr const bool parallel = true;
+
+    inline static utils::fork_join_pool& pool() noexcept {
+        static utils::fork_join_pool instance;
+        return instance;
+    }
+
+    template <typename F1, typename F2>
+    inline static void invoke(F1&& f1, F2&& f2) noexcept {
+        pool().invoke(f1, f2);
+    }
+
+    using barrier = utils::spin_barrier;
+
+    // Runs both functions at the same time, f2 on an idle worker of the
+    // pool, so they may wait for each other.  Returns false without running
+    // them if no worker is idle or there is a single hardware thread.
+    template <typename F1, typename F2>
+    inline static bool concurrent(F1&& f1, F2&& f2) noexcept {
+        return pool().concurrent(f1, f2);
+    }
+};
+
+}  // namespace traits
+
+using threadpool_executor_traits = traits::executor_traits<traits::ThreadPoolExecutor>;
+
+}  // namespace dmp
+
+#endif
@@ -65,6 +65,15 @@ namespace types {
  */
 enum class Operation { DELETE, INSERT, EQUAL };
 
+/**
+ * Cleanups run by diff_cleanup, combined with |.
+ * SEMANTIC includes SEMANTIC_LOSSLESS.
+ */
+enum class Cleanup : unsigned { NONE = 0, MERGE = 1, SEMANTIC = 2, SEMANTIC_LOSSLESS = 4, EFFICIENCY = 8 };
+
+inline constexpr Cleanup operator|(Cleanup a, Cleanup b) noexcept { return static_cast<Cleanup>(static_cast<unsigned>(a) | static_cast<unsigned>(b)); }
+inline constexpr Cleanup operator&(Cleanup a, Cleanup b) noexcept { return static_cast<Cleanup>(static_cast<unsigned>(a) & static_cast<unsigned>(b)); }
+
 /**
  * Class representing one diff Operation::
  */
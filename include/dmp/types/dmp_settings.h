@@ -57,6 +57,14 @@ int main(int argc, char **argv) {
 namespace dmp {
 namespace types {
 
+/**
+ * Algorithm used to diff the lines in line mode.
+ * MYERS diffs the line encoded texts like any other text.
+ * PATIENCE aligns the lines which are unique in both texts first.
+ * HISTOGRAM aligns the least frequent lines first.
+ */
+enum class LineDiff { MYERS, PATIENCE, HISTOGRAM };
+
 struct settings {
 
     // Defaults.
@@ -64,6 +72,21 @@ struct settings {
 
     // Number of seconds to map a diff before giving up (0 for infinity).
     float Diff_Timeout = 1.0f;
+
+    // Number of diagonals diff_bisect may visit in one diff before giving
+    // up (0 for infinity).  Unlike Diff_Timeout the result doesn't depend on
+    // the speed of the machine.  The work consumed by a diff is reported in
+    // its diff_workspace.  Parallel executor_traits diff serially while set.
+    int Diff_MaxWork = 0;
+
+    // Algorithm to diff the lines with, if a line-level diff is run first.
+    LineDiff Diff_LineAlgorithm = LineDiff::MYERS;
+
+    // Combined length of both texts from which lines unique in both texts
+    // split the texts into independently diffed segments first (0 for
+    // never).  Only used with checklines, like the line-level diff.
+    int Diff_AnchorThreshold = 4000000;
+
     // Cost of an empty edit operation in terms of edit characters.
 
     short Diff_EditCost = 4;
@@ -88,6 +111,17 @@ struct settings {
     // The number of bits in an int.
     short Match_MaxBits = 32;
 
+    // Minimum length of both texts of each of two independent sub diffs to
+    // compute them in parallel (0 for never).  Only used with a parallel
+    // executor_traits, the result is the same as the serial one unless
+    // Diff_Timeout cuts the diff short.
+    int Diff_ParallelThreshold = 10000;
+
+    // Minimum combined length of both texts to walk the front and the
+    // reverse path of diff_bisect on two threads (0 for never).  Only used
+    // with a parallel executor_traits, the middle snake is the same.
+    int Diff_ParallelBisectThreshold = 100000;
+
 public:
     constexpr settings() noexcept = default;
 };
@@ -0,0 +1,153 @@
+/*
+ * Diff Match and Patch
+ * Copyright 2020 The diff-match-patch Authors.
+ * https://github.com/google/diff-match-patch
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * Functions for diff, match and patch.
+ * Computes the difference between two texts to create a patch.
+ * Applies the patch onto another text, allowing for errors.
+ *
+ * @author fraser@google.com (Neil Fraser)
+ *
+ * STL-only port by snhere@gmail.com (Sergey Nozhenko)
+ * and some tweaks for std::string by leutloff@sundancer.oche.de (Christian Leutloff)
+ * rebased on the current C# version and added constexpr-ness by guntersp0@gmail.com (Gunter Spöcker):
+ *
+ * Here is a trivial sample program:
+
+#include "diff_match_patch.h"
+#include <string>
+using namespace std;
+int main(int argc, char **argv) {
+    diff_match_patch<all_traits<std_wstring_traits, chrono_clock_traits, std_container_traits>> dmp;
+
+    wstring str1 = L"First string in diff";
+    wstring str2 = L"Second string in diff";
+
+    wstring strPatch = dmp.patch_toText(dmp.patch_make(str1, str2));
+    auto    out(dmp.patch_apply(dmp.patch_fromText(strPatch), str1));
+    wstring strResult(out.text2);
+
+    // here, strResult will equal str2 above.
+    std::wcout << strResult << "\n";
+    return 0;
+}
+*/
+
+
+#ifndef DIFF_MATCH_PATCH_TOKENIZER_H
+#define DIFF_MATCH_PATCH_TOKENIZER_H
+
+
+#include "dmp/utils/dmp_unicode.h"
+#include "dmp/utils/dmp_utils.h"
+
+#include <type_traits>
+
+namespace dmp {
+namespace types {
+
+/**
+ * Tokenizers split a text into the tokens diffed by diff_tokenMode.
+ * A tokenizer is called with the text and the start of the next token and
+ * returns the end of that token, which must be greater than the start.
+ * Any callable with the same signature can be used as a tokenizer.
+ */
+
+/**
+ * Splits a text into lines, each including its line break.
+ */
+struct line_tokenizer {
+    template <typename string_view_t>
+    inline constexpr size_t operator()(const string_view_t& text, size_t start) const noexcept {
+        using char_t = typename string_view_t::char_t;
+
+        size_t end = text.indexOf(static_cast<char_t>('\n'), start);
+        if (end >= text.length()) {
+            return text.length();
+        }
+        return end + 1;
+    }
+};
+
+/**
+ * Splits a text at whitespace, each token is a run of non-whitespace
+ * characters including the whitespace following it.
+ */
+struct whitespace_tokenizer {
+    template <typename string_view_t>
+    inline constexpr size_t operator()(const string_view_t& text, size_t start) const noexcept {
+        auto   data(text.data());
+        size_t len(text.length());
+        size_t end = start;
+        while (end < len && !utils::isSpace(data[end])) {
+            end++;
+        }
+        while (end < len && utils::isSpace(data[end])) {
+            end++;
+        }
+        return end;
+    }
+};
+
+/**
+ * Splits a text into words and punctuation.  A token is a run of word
+ * characters (letters, digits and '_'), a run of whitespace or a single
+ * punctuation character.  Non-ASCII characters are decoded and classified
+ * with utils::classify_code_point, so they are never split.
+ */
+struct word_tokenizer {
+    // Class of the character at data[i], next receives the index after it.
+    template <typename char_t>
+    inline static constexpr utils::code_point_class classify(const char_t* data, size_t len, size_t i, size_t& next) noexcept {
+        using uchar_t = std::make_unsigned_t<char_t>;
+
+        char_t c = data[i];
+        if (static_cast<uchar_t>(c) < 0x80) {
+            next = i + 1;
+            if (utils::isAlphaNum(c) || c == static_cast<char_t>('_')) {
+                return utils::code_point_class::letter;
+            }
+            return utils::isSpace(c) ? utils::code_point_class::space : utils::code_point_class::punctuation;
+        }
+        unsigned u = 0;
+        next       = utils::next_code_point(data, len, i, u);
+        return utils::classify_code_point(u);
+    }
+
+    template <typename string_view_t>
+    inline constexpr size_t operator()(const string_view_t& text, size_t start) const noexcept {
+        auto   data(text.data());
+        size_t len(text.length());
+        size_t end   = start;
+        auto   first = classify(data, len, start, end);
+        if (first == utils::code_point_class::punctuation) {
+            return end;
+        }
+        size_t next = end;
+        while (end < len && classify(data, len, end, next) == first) {
+            end = next;
+        }
+        return end;
+    }
+};
+
+}  // namespace types
+}  // namespace dmp
+
+#endif
@@ -54,6 +54,7 @@ int main(int argc, char **argv) {
 #define DIFF_MATCH_PATCH_ENCODING_H
 
 
+#include "dmp/utils/dmp_simd.h"
 #include "dmp/utils/dmp_unicode.h"
 #include "dmp/utils/dmp_utils.h"
 
@@ -256,34 +257,95 @@ inline static constexpr Stream& encodeURI(Stream& s, const string_view_t& str) n
 }
 
 
-template <typename char_traits, typename Stream, typename string_view_t>
-inline static constexpr Stream& writeHtml(Stream& s, const string_view_t& str) noexcept {
-    using char_t = typename char_traits::char_t;
+/**
+ * An ASCII literal in the character type of a string.
+ */
+template <typename char_t, size_t size>
+struct widened_literal {
+    char_t chars[size] {};
+
+    inline static constexpr size_t length = size - 1;
+};
+
+template <typename char_t, size_t size>
+inline constexpr widened_literal<char_t, size> widen(const char (&str)[size]) noexcept {
+    widened_literal<char_t, size> r {};
+    for (size_t i = 0; i < size; i++) {
+        r.chars[i] = static_cast<char_t>(str[i]);
+    }
+    return r;
+}
+
+
+namespace internal {
+
+template <typename char_t>
+struct html_escapes {
+    inline static constexpr auto amp  = widen<char_t>("&amp;");
+    inline static constexpr auto lt   = widen<char_t>("&lt;");
+    inline static constexpr auto gt   = widen<char_t>("&gt;");
+    inline static constexpr auto para = widen<char_t>("&para;<br>");
+};
+
+}  // namespace internal
 
-    for (auto c : str) {
-        switch (c) {
+
+/**
+ * Split a string into runs of plain text and the escapes of '&', '<', '>'
+ * and newline, and pass them in order to the callback.
+ */
+template <typename char_traits, typename string_view_t, typename Callback>
+inline static constexpr void forEachHtmlPiece(const string_view_t& str, Callback&& piece) noexcept {
+    using char_t  = typename char_traits::char_t;
+    using escapes = internal::html_escapes<char_t>;
+
+    auto   d(str.data());
+    size_t n(str.length());
+    size_t i = 0;
+    while (i < n) {
+        size_t j = i + findFirstOf(d + i, n - i, char_traits::cast('&'), char_traits::cast('<'), char_traits::cast('>'), char_traits::cast('\n'));
+        if (j > i) {
+            piece(string_view_t(d + i, j - i));
+        }
+        if (j == n) {
+            break;
+        }
+
+        switch (d[j]) {
             case static_cast<char_t>('&'):
-                char_traits::write(s, "&amp;");
+                piece(string_view_t(escapes::amp.chars, escapes::amp.length));
                 break;
 
             case static_cast<char_t>('<'):
-                char_traits::write(s, "&lt;");
+                piece(string_view_t(escapes::lt.chars, escapes::lt.length));
                 break;
 
             case static_cast<char_t>('>'):
-                char_traits::write(s, "&gt;");
-                break;
-
-            case static_cast<char_t>('\n'):
-                char_traits::write(s, "&para;<br>");
+                piece(string_view_t(escapes::gt.chars, escapes::gt.length));
                 break;
 
             default:
-                char_traits::write(s, c);
+                piece(string_view_t(escapes::para.chars, escapes::para.length));
                 break;
         }
+        i = j + 1;
     }
+}
+
+/**
+ * Length of a string after writeHtml.
+ */
+template <typename char_traits, typename string_view_t>
+inline static constexpr size_t htmlLength(const string_view_t& str) noexcept {
+    size_t length = 0;
+    forEachHtmlPiece<char_traits>(str, [&length](const string_view_t& piece) { length += piece.length(); });
+    return length;
+}
+
 
+template <typename char_traits, typename Stream, typename string_view_t>
+inline static constexpr Stream& writeHtml(Stream& s, const string_view_t& str) noexcept {
+    forEachHtmlPiece<char_traits>(str, [&s](const string_view_t& piece) { writeToStream(s, piece); });
     return s;
 }
 
@@ -0,0 +1,188 @@
+/*
+ * Diff Match and Patch
+ * Copyright 2020 The diff-match-patch Authors.
+ * https://github.com/google/diff-match-patch
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * Functions for diff, match and patch.
+ * Computes the difference between two texts to create a patch.
+ * Applies the patch onto another text, allowing for errors.
+ *
+ * @author fraser@google.com (Neil Fraser)
+ *
+ * STL-only port by snhere@gmail.com (Sergey Nozhenko)
+ * and some tweaks for std::string by leutloff@sundancer.oche.de (Christian Leutloff)
+ * rebased on the current C# version and added constexpr-ness by guntersp0@gmail.com (Gunter Spöcker):
+ *
+ * Here is a trivial sample program:
+
+#include "diff_match_patch.h"
+#include <string>
+using namespace std;
+int main(int argc, char **argv) {
+    diff_match_patch<all_traits<std_wstring_traits, chrono_clock_traits, std_container_traits>> dmp;
+
+    wstring str1 = L"First string in diff";
+    wstring str2 = L"Second string in diff";
+
+    wstring strPatch = dmp.patch_toText(dmp.patch_make(str1, str2));
+    auto    out(dmp.patch_apply(dmp.patch_fromText(strPatch), str1));
+    wstring strResult(out.text2);
+
+    // here, strResult will equal str2 above.
+    std::wcout << strResult << "\n";
+    return 0;
+}
+*/
+
+
+#ifndef DIFF_MATCH_PATCH_LINEHASH_H
+#define DIFF_MATCH_PATCH_LINEHASH_H
+
+
+#include <cstdint>
+#include <cstddef>
+
+
+namespace dmp {
+namespace utils {
+
+
+template <typename key, typename value>
+struct line_hash_item {
+    key      first {};
+    value    second {};
+    uint64_t hash = 0;
+};
+
+
+/**
+ * Hash map from lines to their indices.
+ * The 64 bit hash of each line is computed once and kept next to it, so
+ * probing and growing compare hashes and only compare strings on a hit.
+ * Open addressing with linear probing in a power of two sized table,
+ * the items are iterated in insertion order.
+ */
+template <typename key, typename value, template <typename> class list_t>
+struct line_hash {
+    using item_t = line_hash_item<key, value>;
+
+private:
+    list_t<item_t> items;
+    // Index + 1 of the item, 0 for an empty slot.
+    list_t<size_t> slots;
+
+public:
+    constexpr line_hash() noexcept = default;
+
+    inline constexpr size_t size() const noexcept { return items.size(); }
+    inline constexpr bool   empty() const noexcept { return items.empty(); }
+
+    inline constexpr void clear() noexcept {
+        if (items.size() * 4 < slots.size()) {
+            // Only reset the used slots of a sparse table, so a large table
+            // reused for small texts is cleared in time of its items.
+            size_t mask(slots.size() - 1);
+            for (size_t n = 0; n < items.size(); n++) {
+                size_t i(items[n].hash & mask);
+                while (slots[i] != n + 1) {
+                    i = (i + 1) & mask;
+                }
+                slots[i] = 0;
+            }
+        } else {
+            for (auto& s : slots) {
+                s = 0;
+            }
+        }
+        items.clear();
+    }
+
+    inline constexpr auto begin() const noexcept { return items.begin(); }
+    inline constexpr auto end() const noexcept { return items.end(); }
+
+    /**
+     * Find the value of a key, inserting the given one if it's missing.
+     * @param k Key to look up.
+     * @param v Value to insert.
+     * @return Reference to the value of the key.
+     */
+    inline constexpr value& insertAndReturnValue(const key& k, value v) noexcept {
+        uint64_t h(hash(k));
+
+        // Keep the load factor below 1/2.
+        if ((items.size() + 1) * 2 > slots.size()) {
+            grow();
+        }
+
+        size_t mask(slots.size() - 1);
+        for (size_t i = h & mask;; i = (i + 1) & mask) {
+            size_t s(slots[i]);
+            if (s == 0) {
+                items.push_back(item_t { k, v, h });
+                slots[i] = items.size();
+                return items.back().second;
+            }
+
+            auto& item(items[s - 1]);
+            if (item.hash == h && item.first == k) {
+                return item.second;
+            }
+        }
+    }
+
+    /**
+     * 64 bit hash of the characters of a key.
+     */
+    inline static constexpr uint64_t hash(const key& k) noexcept {
+        auto     d(k.data());
+        size_t   len(k.length());
+        uint64_t h(0x9E3779B97F4A7C15u ^ len);
+        for (size_t i = 0; i < len; i++) {
+            h = (h ^ static_cast<uint64_t>(d[i])) * 0x100000001B3u;
+        }
+
+        // Mix the high bits into the low ones used for the table index.
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDu;
+        h ^= h >> 33;
+        return h;
+    }
+
+private:
+    inline constexpr void grow() noexcept {
+        size_t capacity(slots.empty() ? 64 : slots.size() * 2);
+        slots.clear();
+        slots.resize(capacity, 0);
+
+        // Rehash from the stored hashes.
+        size_t mask(capacity - 1);
+        for (size_t n = 0; n < items.size(); n++) {
+            size_t i(items[n].hash & mask);
+            while (slots[i] != 0) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = n + 1;
+        }
+    }
+};
+
+
+}  // namespace utils
+}  // namespace dmp
+
+#endif
@@ -0,0 +1,206 @@
+/*
+ * Diff Match and Patch
+ * Copyright 2020 The diff-match-patch Authors.
+ * https://github.com/google/diff-match-patch
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * Functions for diff, match and patch.
+ * Computes the difference between two texts to create a patch.
+ * Applies the patch onto another text, allowing for errors.
+ *
+ * @author fraser@google.com (Neil Fraser)
+ *
+ * STL-only port by snhere@gmail.com (Sergey Nozhenko)
+ * and some tweaks for std::string by leutloff@sundancer.oche.de (Christian Leutloff)
+ * rebased on the current C# version and added constexpr-ness by guntersp0@gmail.com (Gunter Spöcker):
+ *
+ * Here is a trivial sample program:
+
+#include "diff_match_patch.h"
+#include <string>
+using namespace std;
+int main(int argc, char **argv) {
+    diff_match_patch<all_traits<std_wstring_traits, chrono_clock_traits, std_container_traits>> dmp;
+
+    wstring str1 = L"First string in diff";
+    wstring str2 = L"Second string in diff";
+
+    wstring strPatch = dmp.patch_toText(dmp.patch_make(str1, str2));
+    auto    out(dmp.patch_apply(dmp.patch_fromText(strPatch), str1));
+    wstring strResult(out.text2);
+
+    // here, strResult will equal str2 above.
+    std::wcout << strResult << "\n";
+    return 0;
+}
+*/
+
+
+#ifndef DIFF_MATCH_PATCH_MAPPEDFILE_H
+#define DIFF_MATCH_PATCH_MAPPEDFILE_H
+
+
+#include <cstddef>
+#include <memory>
+
+#if defined(_WIN32)
+// windows.h isn't allowed to leak its macros, winnt.h defines DELETE which
+// clashes with Operation::DELETE.
+#    pragma push_macro("DELETE")
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#        define DMP_UNDEF_NOMINMAX
+#    endif
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#        define DMP_UNDEF_WIN32_LEAN_AND_MEAN
+#    endif
+#    include <windows.h>
+#    ifdef DMP_UNDEF_NOMINMAX
+#        undef NOMINMAX
+#        undef DMP_UNDEF_NOMINMAX
+#    endif
+#    ifdef DMP_UNDEF_WIN32_LEAN_AND_MEAN
+#        undef WIN32_LEAN_AND_MEAN
+#        undef DMP_UNDEF_WIN32_LEAN_AND_MEAN
+#    endif
+#    pragma pop_macro("DELETE")
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace dmp {
+namespace utils {
+
+/**
+ * Read-only memory mapping of a whole file.
+ * The content is used as it is, e.g. as UTF-8 for std::string based traits
+ * or as wchar_t for std::wstring based ones, without any conversion.
+ * Views into the mapping, like the diffs of diff_main on mapped files,
+ * are valid as long as the mapping is alive, so mappings are shared.
+ * diff_match_patch.h doesn't include this header, include it to use the
+ * overloads taking mapped files.
+ */
+class mapped_file {
+    const void* address = nullptr;
+    size_t      length  = 0;
+
+#if defined(_WIN32)
+    HANDLE mapping = nullptr;
+#endif
+
+    struct private_tag {};
+
+public:
+    inline explicit mapped_file(private_tag) noexcept {}
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    inline ~mapped_file() noexcept {
+#if defined(_WIN32)
+        if (address) {
+            UnmapViewOfFile(address);
+        }
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+#else
+        if (address) {
+            munmap(const_cast<void*>(address), length);
+        }
+#endif
+    }
+
+    /**
+     * Map a file.
+     * @param path Path of the file.
+     * @return The mapping, or null if the file can't be opened or mapped.
+     */
+    inline static std::shared_ptr<const mapped_file> open(const char* path) noexcept {
+        auto file(std::make_shared<mapped_file>(private_tag {}));
+
+#if defined(_WIN32)
+        HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            return nullptr;
+        }
+
+        LARGE_INTEGER size;
+        bool          ok = GetFileSizeEx(handle, &size) != 0;
+        if (ok && size.QuadPart > 0) {
+            file->mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            file->address = file->mapping ? MapViewOfFile(file->mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            file->length  = static_cast<size_t>(size.QuadPart);
+            ok            = file->address != nullptr;
+        }
+        CloseHandle(handle);
+#else
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            return nullptr;
+        }
+
+        struct stat st;
+        bool        ok = fstat(fd, &st) == 0;
+        if (ok && st.st_size > 0) {
+            void* address = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address != MAP_FAILED) {
+                file->address = address;
+                file->length  = static_cast<size_t>(st.st_size);
+            } else {
+                ok = false;
+            }
+        }
+        // The mapping stays valid without the descriptor.
+        ::close(fd);
+#endif
+
+        if (!ok) {
+            return nullptr;
+        }
+        return file;
+    }
+
+    inline const void* data() const noexcept { return address; }
+
+    /**
+     * Size of the file in bytes.
+     */
+    inline size_t size() const noexcept { return length; }
+
+    /**
+     * The content of the file as a string of the given string view type.
+     * Trailing bytes which don't make up a whole character are left out.
+     */
+    template <typename string_view_t>
+    inline string_view_t text() const noexcept {
+        using char_t = typename string_view_t::char_t;
+        if (!address) {
+            return string_view_t {};
+        }
+        return string_view_t { static_cast<const char_t*>(address), length / sizeof(char_t) };
+    }
+};
+
+}  // namespace utils
+}  // namespace dmp
+
+#endif
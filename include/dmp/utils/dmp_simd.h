@@ -0,0 +1,455 @@
+/*
+ * Diff Match and Patch
+ * Copyright 2020 The diff-match-patch Authors.
+ * https://github.com/google/diff-match-patch
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * Functions for diff, match and patch.
+ * Computes the difference between two texts to create a patch.
+ * Applies the patch onto another text, allowing for errors.
+ *
+ * @author fraser@google.com (Neil Fraser)
+ *
+ * STL-only port by snhere@gmail.com (Sergey Nozhenko)
+ * and some tweaks for std::string by leutloff@sundancer.oche.de (Christian Leutloff)
+ * rebased on the current C# version and added constexpr-ness by guntersp0@gmail.com (Gunter Spöcker):
+ *
+ * Here is a trivial sample program:
+
+#include "diff_match_patch.h"
+#include <string>
+using namespace std;
+int main(int argc, char **argv) {
+    diff_match_patch<all_traits<std_wstring_traits, chrono_clock_traits, std_container_traits>> dmp;
+
+    wstring str1 = L"First string in diff";
+    wstring str2 = L"Second string in diff";
+
+    wstring strPatch = dmp.patch_toText(dmp.patch_make(str1, str2));
+    auto    out(dmp.patch_apply(dmp.patch_fromText(strPatch), str1));
+    wstring strResult(out.text2);
+
+    // here, strResult will equal str2 above.
+    std::wcout << strResult << "\n";
+    return 0;
+}
+*/
+
+
+#ifndef DIFF_MATCH_PATCH_SIMD_H
+#define DIFF_MATCH_PATCH_SIMD_H
+
+
+#include "dmp/utils/dmp_utils.h"
+
+#include <cstring>
+#include <type_traits>
+
+
+#ifndef DONT_USE_SIMD_INTRINSICS
+#    if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#        define DMP_SIMD_SSE2
+#        include <emmintrin.h>
+#    endif
+#    if defined(__AVX2__)
+#        define DMP_SIMD_AVX2
+#        include <immintrin.h>
+#    endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#endif
+
+#if defined(__has_builtin)
+#    if __has_builtin(__builtin_is_constant_evaluated)
+#        define DMP_HAS_BUILTIN_IS_CONSTANT_EVALUATED
+#    endif
+#endif
+#if !defined(DMP_HAS_BUILTIN_IS_CONSTANT_EVALUATED) && ((defined(__GNUC__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925))
+#    define DMP_HAS_BUILTIN_IS_CONSTANT_EVALUATED
+#endif
+
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_WIN32)
+#    define DMP_SWAR_LITTLE_ENDIAN
+#elif defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#    define DMP_SWAR_BIG_ENDIAN
+#endif
+
+
+namespace dmp {
+namespace utils {
+
+/**
+ * Detect whether the current evaluation is a constant expression. The vectorized
+ * kernels below are only used at runtime, so that everything stays constexpr.
+ * Without compiler support the scalar code is always used.
+ */
+inline constexpr bool is_constant_evaluated() noexcept {
+#if defined(__cpp_lib_is_constant_evaluated)
+    return std::is_constant_evaluated();
+#elif defined(DMP_HAS_BUILTIN_IS_CONSTANT_EVALUATED)
+    return __builtin_is_constant_evaluated();
+#else
+    return true;
+#endif
+}
+
+
+namespace internal {
+
+template <typename char_t>
+inline constexpr bool is_simd_comparable = std::is_integral_v<char_t> && (sizeof(char_t) == 1 || sizeof(char_t) == 2 || sizeof(char_t) == 4);
+
+
+inline static int countTrailingZeros(uint32_t v) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(v);
+#elif defined(_MSC_VER)
+    unsigned long i {};
+    _BitScanForward(&i, v);
+    return static_cast<int>(i);
+#else
+    int n = 0;
+    while ((v & 1u) == 0) {
+        v >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+inline static int countLeadingZeros(uint32_t v) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clz(v);
+#elif defined(_MSC_VER)
+    unsigned long i {};
+    _BitScanReverse(&i, v);
+    return 31 - static_cast<int>(i);
+#else
+    int n = 0;
+    while ((v & 0x80000000u) == 0) {
+        v <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+inline static int countTrailingZeros(uint64_t v) noexcept {
+    auto low(static_cast<uint32_t>(v));
+    return low != 0 ? countTrailingZeros(low) : 32 + countTrailingZeros(static_cast<uint32_t>(v >> 32));
+}
+
+inline static int countLeadingZeros(uint64_t v) noexcept {
+    auto high(static_cast<uint32_t>(v >> 32));
+    return high != 0 ? countLeadingZeros(high) : 32 + countLeadingZeros(static_cast<uint32_t>(v));
+}
+
+
+/**
+ * Number of equal bytes at the start of both buffers.
+ */
+inline static size_t equalPrefixBytes(const unsigned char* a, const unsigned char* b, size_t length) noexcept {
+    size_t i = 0;
+
+#ifdef DMP_SIMD_AVX2
+    for (; i + 32 <= length; i += 32) {
+        __m256i va(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+        __m256i vb(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        auto    mask(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb))));
+        if (mask != 0xFFFFFFFFu) {
+            return i + static_cast<size_t>(countTrailingZeros(~mask));
+        }
+    }
+#endif
+
+#ifdef DMP_SIMD_SSE2
+    for (; i + 16 <= length; i += 16) {
+        __m128i va(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        __m128i vb(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        auto    mask(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb))));
+        if (mask != 0xFFFFu) {
+            return i + static_cast<size_t>(countTrailingZeros(~mask & 0xFFFFu));
+        }
+    }
+#endif
+
+#if defined(DMP_SWAR_LITTLE_ENDIAN) || defined(DMP_SWAR_BIG_ENDIAN)
+    for (; i + 8 <= length; i += 8) {
+        uint64_t va {};
+        uint64_t vb {};
+        std::memcpy(&va, a + i, 8);
+        std::memcpy(&vb, b + i, 8);
+        if (va != vb) {
+#    ifdef DMP_SWAR_LITTLE_ENDIAN
+            return i + static_cast<size_t>(countTrailingZeros(va ^ vb) / 8);
+#    else
+            return i + static_cast<size_t>(countLeadingZeros(va ^ vb) / 8);
+#    endif
+        }
+    }
+#endif
+
+    for (; i < length; i++) {
+        if (a[i] != b[i]) {
+            return i;
+        }
+    }
+    return length;
+}
+
+/**
+ * Number of equal bytes directly before the end pointers of both buffers.
+ */
+inline static size_t equalSuffixBytes(const unsigned char* aEnd, const unsigned char* bEnd, size_t length) noexcept {
+    size_t i = 0;
+
+#ifdef DMP_SIMD_AVX2
+    for (; i + 32 <= length; i += 32) {
+        __m256i va(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(aEnd - i - 32)));
+        __m256i vb(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bEnd - i - 32)));
+        auto    mask(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb))));
+        if (mask != 0xFFFFFFFFu) {
+            return i + static_cast<size_t>(countLeadingZeros(~mask));
+        }
+    }
+#endif
+
+#ifdef DMP_SIMD_SSE2
+    for (; i + 16 <= length; i += 16) {
+        __m128i va(_mm_loadu_si128(reinterpret_cast<const __m128i*>(aEnd - i - 16)));
+        __m128i vb(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bEnd - i - 16)));
+        auto    mask(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb))));
+        if (mask != 0xFFFFu) {
+            return i + static_cast<size_t>(countLeadingZeros(~mask & 0xFFFFu) - 16);
+        }
+    }
+#endif
+
+#if defined(DMP_SWAR_LITTLE_ENDIAN) || defined(DMP_SWAR_BIG_ENDIAN)
+    for (; i + 8 <= length; i += 8) {
+        uint64_t va {};
+        uint64_t vb {};
+        std::memcpy(&va, aEnd - i - 8, 8);
+        std::memcpy(&vb, bEnd - i - 8, 8);
+        if (va != vb) {
+#    ifdef DMP_SWAR_LITTLE_ENDIAN
+            return i + static_cast<size_t>(countLeadingZeros(va ^ vb) / 8);
+#    else
+            return i + static_cast<size_t>(countTrailingZeros(va ^ vb) / 8);
+#    endif
+        }
+    }
+#endif
+
+    for (; i < length; i++) {
+        if (*(aEnd - i - 1) != *(bEnd - i - 1)) {
+            return i;
+        }
+    }
+    return length;
+}
+
+#ifdef DMP_SIMD_SSE2
+template <size_t size>
+inline static __m128i splat128(uint32_t c) noexcept {
+    if constexpr (size == 1) {
+        return _mm_set1_epi8(static_cast<char>(c));
+    } else if constexpr (size == 2) {
+        return _mm_set1_epi16(static_cast<short>(c));
+    } else {
+        return _mm_set1_epi32(static_cast<int>(c));
+    }
+}
+
+template <size_t size>
+inline static __m128i equal128(__m128i a, __m128i b) noexcept {
+    if constexpr (size == 1) {
+        return _mm_cmpeq_epi8(a, b);
+    } else if constexpr (size == 2) {
+        return _mm_cmpeq_epi16(a, b);
+    } else {
+        return _mm_cmpeq_epi32(a, b);
+    }
+}
+#endif
+
+#ifdef DMP_SIMD_AVX2
+template <size_t size>
+inline static __m256i splat256(uint32_t c) noexcept {
+    if constexpr (size == 1) {
+        return _mm256_set1_epi8(static_cast<char>(c));
+    } else if constexpr (size == 2) {
+        return _mm256_set1_epi16(static_cast<short>(c));
+    } else {
+        return _mm256_set1_epi32(static_cast<int>(c));
+    }
+}
+
+template <size_t size>
+inline static __m256i equal256(__m256i a, __m256i b) noexcept {
+    if constexpr (size == 1) {
+        return _mm256_cmpeq_epi8(a, b);
+    } else if constexpr (size == 2) {
+        return _mm256_cmpeq_epi16(a, b);
+    } else {
+        return _mm256_cmpeq_epi32(a, b);
+    }
+}
+#endif
+
+/**
+ * Index of the first of the four values in a buffer of count units of size bytes.
+ * Only whole vectors are tested, the index of the first untested unit is returned
+ * when none of them holds one of the values.
+ */
+template <size_t size>
+inline static size_t findFirstOfUnits(const unsigned char* text, size_t count, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t c4) noexcept {
+    size_t i = 0;
+    (void)text;
+    (void)count;
+    (void)c1;
+    (void)c2;
+    (void)c3;
+    (void)c4;
+
+#ifdef DMP_SIMD_AVX2
+    constexpr size_t lanes256 = 32 / size;
+    if (count >= lanes256) {
+        __m256i v1(splat256<size>(c1));
+        __m256i v2(splat256<size>(c2));
+        __m256i v3(splat256<size>(c3));
+        __m256i v4(splat256<size>(c4));
+        for (; i + lanes256 <= count; i += lanes256) {
+            __m256i v(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i * size)));
+            __m256i m(_mm256_or_si256(_mm256_or_si256(equal256<size>(v, v1), equal256<size>(v, v2)),
+                                      _mm256_or_si256(equal256<size>(v, v3), equal256<size>(v, v4))));
+            auto    mask(static_cast<uint32_t>(_mm256_movemask_epi8(m)));
+            if (mask != 0) {
+                return i + static_cast<size_t>(countTrailingZeros(mask)) / size;
+            }
+        }
+    }
+#endif
+
+#ifdef DMP_SIMD_SSE2
+    constexpr size_t lanes128 = 16 / size;
+    if (count - i >= lanes128) {
+        __m128i v1(splat128<size>(c1));
+        __m128i v2(splat128<size>(c2));
+        __m128i v3(splat128<size>(c3));
+        __m128i v4(splat128<size>(c4));
+        for (; i + lanes128 <= count; i += lanes128) {
+            __m128i v(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i * size)));
+            __m128i m(_mm_or_si128(_mm_or_si128(equal128<size>(v, v1), equal128<size>(v, v2)), _mm_or_si128(equal128<size>(v, v3), equal128<size>(v, v4))));
+            auto    mask(static_cast<uint32_t>(_mm_movemask_epi8(m)));
+            if (mask != 0) {
+                return i + static_cast<size_t>(countTrailingZeros(mask)) / size;
+            }
+        }
+    }
+#endif
+
+    return i;
+}
+
+}  // namespace internal
+
+
+/**
+ * Number of equal characters at the start of both texts, looking at no more than length characters.
+ * Runtime calls on 1, 2 and 4 byte characters compare 8 to 32 bytes per step.
+ */
+template <typename char_t>
+inline constexpr size_t commonPrefixLength(const char_t* text1, const char_t* text2, size_t length) noexcept {
+    if (length == 0 || text1[0] != text2[0]) {
+        return 0;
+    }
+
+    if constexpr (internal::is_simd_comparable<char_t>) {
+        if (!is_constant_evaluated()) {
+            return internal::equalPrefixBytes(reinterpret_cast<const unsigned char*>(text1), reinterpret_cast<const unsigned char*>(text2),
+                                              length * sizeof(char_t))
+                   / sizeof(char_t);
+        }
+    }
+
+    for (size_t i = 1; i < length; i++) {
+        if (text1[i] != text2[i]) {
+            return i;
+        }
+    }
+    return length;
+}
+
+/**
+ * Number of equal characters directly before text1End and text2End, looking at no more than length characters.
+ * Runtime calls on 1, 2 and 4 byte characters compare 8 to 32 bytes per step.
+ */
+template <typename char_t>
+inline constexpr size_t commonSuffixLength(const char_t* text1End, const char_t* text2End, size_t length) noexcept {
+    if (length == 0 || *(text1End - 1) != *(text2End - 1)) {
+        return 0;
+    }
+
+    if constexpr (internal::is_simd_comparable<char_t>) {
+        if (!is_constant_evaluated()) {
+            return internal::equalSuffixBytes(reinterpret_cast<const unsigned char*>(text1End), reinterpret_cast<const unsigned char*>(text2End),
+                                              length * sizeof(char_t))
+                   / sizeof(char_t);
+        }
+    }
+
+    for (size_t i = 1; i < length; i++) {
+        if (*(text1End - i - 1) != *(text2End - i - 1)) {
+            return i;
+        }
+    }
+    return length;
+}
+
+/**
+ * Index of the first of the characters c1 to c4 in the text, or length if there is none.
+ * Runtime calls on 1, 2 and 4 byte characters test 16 or 32 bytes per step.
+ */
+template <typename char_t>
+inline constexpr size_t findFirstOf(const char_t* text, size_t length, char_t c1, char_t c2, char_t c3, char_t c4) noexcept {
+    size_t i = 0;
+
+    if constexpr (internal::is_simd_comparable<char_t>) {
+        if (!is_constant_evaluated()) {
+            using unit_t = std::make_unsigned_t<char_t>;
+
+            i = internal::findFirstOfUnits<sizeof(char_t)>(reinterpret_cast<const unsigned char*>(text), length, static_cast<unit_t>(c1),
+                                                           static_cast<unit_t>(c2), static_cast<unit_t>(c3), static_cast<unit_t>(c4));
+        }
+    }
+
+    for (; i < length; i++) {
+        auto c(text[i]);
+        if (c == c1 || c == c2 || c == c3 || c == c4) {
+            return i;
+        }
+    }
+    return length;
+}
+
+}  // namespace utils
+}  // namespace dmp
+
+#endif
@@ -116,6 +116,7 @@ public:
     }
 
     inline constexpr size_t capacity() const noexcept { return maxItems; }
+    inline constexpr size_t max_size() const noexcept { return maxItems; }
 
     inline constexpr void resize(size_t count) noexcept {
         DMP_ASSERT(count <= maxItems);
@@ -87,6 +87,14 @@ struct string_pool : public string_pool_base<string_view_t, owning_string_t> {
 
     inline constexpr void clear() noexcept { blocks.clear(); }
 
+    // Takes over the strings of another pool, views into them stay valid.
+    inline void adopt(string_pool& other) noexcept {
+        for (auto& b : other.blocks) {
+            blocks.push_back(std::move(b));
+        }
+        other.blocks.clear();
+    }
+
     inline constexpr auto* createNext(size_t length) noexcept {
         strings_type* strings = nullptr;
 
@@ -142,6 +142,26 @@ struct string_pool_base {
         return string_view_t { s, totalLength - l };
     }
 
+    /**
+     * Create a string of the given length, filled by the given function.
+     * It gets the write pointer and the remaining length, and advances
+     * them like str_copy does.
+     */
+    template <typename Function>
+    inline constexpr string_view_t createFilled(size_t totalLength, Function&& fill) noexcept {
+        auto* s(createNext(*this, totalLength));
+        if (!s) {
+            return {};
+        }
+
+        auto l(totalLength);
+        auto p(s);
+
+        fill(p, l);
+
+        return string_view_t { s, totalLength - l };
+    }
+
     template <typename... strings>
     inline constexpr string_view_t create(const strings&... args) noexcept {
         size_t l = (0 + ... + args.length());
@@ -243,6 +263,58 @@ public:
         return first;
     }
 
+    /**
+     * Join the strings piece(0) ... piece(count - 1) like appended does, but
+     * copying them once at most.
+     */
+    template <typename Piece>
+    inline constexpr string_view_t joined(size_t count, Piece&& piece) noexcept {
+        size_t        totalLength = 0;
+        size_t        nonEmpty    = 0;
+        string_view_t first {};
+        for (size_t i = 0; i < count; i++) {
+            string_view_t s(piece(i));
+            if (s.length() != 0) {
+                if (nonEmpty++ == 0) {
+                    first = s;
+                }
+                totalLength += s.length();
+            }
+        }
+        if (nonEmpty <= 1) {
+            return first;
+        }
+
+        auto d(first.data());
+
+        for (size_t i = 0; i < textsData.num; i++) {
+            auto& t(textsData.texts[i]);
+
+            if (t.begin && d >= t.begin && d < t.end && d + totalLength <= t.end) {
+                // check if the strings follow each other in the original text. If so, just reuse them
+                auto p(d);
+                bool expandable = true;
+                for (size_t j = 0; j < count && expandable; j++) {
+                    string_view_t s(piece(j));
+                    expandable = s == string_view_t(p, s.length());
+                    p += s.length();
+                }
+                if (expandable) {
+                    return string_view_t { d, totalLength };
+                }
+            }
+        }
+
+        // fallback, create a new string
+        return createFilled(totalLength, [&](auto& p, auto& l) {
+            using namespace dmp::utils;
+
+            for (size_t j = 0; j < count; j++) {
+                str_copy(p, l, piece(j));
+            }
+        });
+    }
+
 
     template <typename char_traits>
     inline constexpr bool percent_decode(string_view_t& str, bool replacePluses) noexcept {
@@ -0,0 +1,312 @@
+/*
+ * Diff Match and Patch
+ * Copyright 2020 The diff-match-patch Authors.
+ * https://github.com/google/diff-match-patch
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * Functions for diff, match and patch.
+ * Computes the difference between two texts to create a patch.
+ * Applies the patch onto another text, allowing for errors.
+ *
+ * @author fraser@google.com (Neil Fraser)
+ *
+ * STL-only port by snhere@gmail.com (Sergey Nozhenko)
+ * and some tweaks for std::string by leutloff@sundancer.oche.de (Christian Leutloff)
+ * rebased on the current C# version and added constexpr-ness by guntersp0@gmail.com (Gunter Spöcker):
+ *
+ * Here is a trivial sample program:
+
+#include "diff_match_patch.h"
+#include <string>
+using namespace std;
+int main(int argc, char **argv) {
+    diff_match_patch<all_traits<std_wstring_traits, chrono_clock_traits, std_container_traits>> dmp;
+
+    wstring str1 = L"First string in diff";
+    wstring str2 = L"Second string in diff";
+
+    wstring strPatch = dmp.patch_toText(dmp.patch_make(str1, str2));
+    auto    out(dmp.patch_apply(dmp.patch_fromText(strPatch), str1));
+    wstring strResult(out.text2);
+
+    // here, strResult will equal str2 above.
+    std::wcout << strResult << "\n";
+    return 0;
+}
+*/
+
+
+#ifndef DIFF_MATCH_PATCH_THREADPOOL_H
+#define DIFF_MATCH_PATCH_THREADPOOL_H
+
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace dmp {
+namespace utils {
+
+/**
+ * Small fork-join thread pool.
+ * invoke() runs the first function on the calling thread and queues the
+ * second one for the workers.  Waiting threads execute queued tasks
+ * themselves, so nested invokes never run out of threads.
+ * Each worker queues its forks in a deque of its own and runs the newest
+ * of them first, idle threads steal the oldest, i.e. biggest, task of
+ * another deque.  Threads outside of the pool share one more deque.
+ * concurrent() hands the second function to an idle worker instead, so
+ * both functions are guaranteed to run at the same time.
+ */
+class fork_join_pool {
+    struct task {
+        void (*run)(void*) = nullptr;
+        void*             data = nullptr;
+        std::atomic<bool> done { false };
+    };
+
+    struct task_queue {
+        std::mutex        mutex;
+        std::deque<task*> tasks;
+    };
+
+    // Index 0 is shared by the threads outside of the pool.
+    std::unique_ptr<task_queue[]> queues;
+    size_t                        queueCount;
+    std::atomic<size_t>           pending { 0 };
+
+    std::mutex               mutex;
+    std::condition_variable  changed;
+    std::deque<task*>        concurrentTasks;
+    std::vector<std::thread> workers;
+    size_t                   idle     = 0;
+    bool                     stopping = false;
+
+    inline static thread_local const fork_join_pool* currentPool  = nullptr;
+    inline static thread_local size_t                currentQueue = 0;
+
+public:
+    inline explicit fork_join_pool(size_t threads = std::thread::hardware_concurrency()) noexcept
+        : queues(new task_queue[(std::max)(threads, size_t { 1 })])
+        , queueCount((std::max)(threads, size_t { 1 })) {
+        // The calling thread always takes part in the work.
+        for (size_t i = 1; i < threads; i++) {
+            workers.emplace_back([this, i]() { work(i); });
+        }
+    }
+
+    fork_join_pool(const fork_join_pool&) = delete;
+    fork_join_pool& operator=(const fork_join_pool&) = delete;
+
+    inline ~fork_join_pool() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        changed.notify_all();
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+
+    inline size_t threads() const noexcept { return workers.size() + 1; }
+
+    /**
+     * Run both functions, possibly in parallel, and return when both are done.
+     * @param f1 Function run on the calling thread.
+     * @param f2 Function offered to the pool.
+     */
+    template <typename F1, typename F2>
+    inline void invoke(F1&& f1, F2&& f2) noexcept {
+        if (workers.empty()) {
+            f1();
+            f2();
+            return;
+        }
+
+        task t;
+        t.run  = &runFunction<std::remove_reference_t<F2>>;
+        t.data = &f2;
+        size_t own(currentPool == this ? currentQueue : 0);
+        push(own, t);
+
+        f1();
+
+        // Help out until the forked task is done, most likely it's still queued.
+        while (!t.done.load(std::memory_order_acquire)) {
+            if (task* next = take(own)) {
+                execute(*next);
+            } else {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [this, &t]() { return t.done.load(std::memory_order_acquire) || pending.load() > 0; });
+            }
+        }
+    }
+
+    /**
+     * Run both functions at the same time and return when both are done, so
+     * they may wait for each other.
+     * @param f1 Function run on the calling thread.
+     * @param f2 Function run on an idle worker.
+     * @return false without running either function if no worker is idle
+     *     or the hardware runs a single thread only.
+     */
+    template <typename F1, typename F2>
+    inline bool concurrent(F1&& f1, F2&& f2) noexcept {
+        if (std::thread::hardware_concurrency() < 2) {
+            return false;
+        }
+
+        task t;
+        t.run  = &runFunction<std::remove_reference_t<F2>>;
+        t.data = &f2;
+        {
+            // Idle workers take concurrent tasks first, so each queued one
+            // has a worker of its own.
+            std::lock_guard<std::mutex> lock(mutex);
+            if (idle <= concurrentTasks.size()) {
+                return false;
+            }
+            concurrentTasks.push_back(&t);
+        }
+        changed.notify_all();
+
+        f1();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&t]() { return t.done.load(std::memory_order_acquire); });
+        return true;
+    }
+
+private:
+    template <typename F>
+    inline static void runFunction(void* f) noexcept {
+        (*static_cast<F*>(f))();
+    }
+
+    inline void push(size_t own, task& t) noexcept {
+        {
+            // Publish under the pool mutex, so no sleeping thread misses it.
+            std::lock_guard<std::mutex> lock(mutex);
+            std::lock_guard<std::mutex> queueLock(queues[own].mutex);
+            queues[own].tasks.push_back(&t);
+            pending.fetch_add(1);
+        }
+        changed.notify_one();
+    }
+
+    // Newest task of the own deque, or else the oldest of another one.
+    inline task* take(size_t own) noexcept {
+        for (size_t i = 0; i < queueCount; i++) {
+            auto&                       queue(queues[(own + i) % queueCount]);
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task* next;
+                if (i == 0) {
+                    next = queue.tasks.back();
+                    queue.tasks.pop_back();
+                } else {
+                    next = queue.tasks.front();
+                    queue.tasks.pop_front();
+                }
+                pending.fetch_sub(1);
+                return next;
+            }
+        }
+        return nullptr;
+    }
+
+    inline void execute(task& t) noexcept {
+        t.run(t.data);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            t.done.store(true, std::memory_order_release);
+        }
+        changed.notify_all();
+    }
+
+    inline void work(size_t own) noexcept {
+        currentPool  = this;
+        currentQueue = own;
+        for (;;) {
+            task* next = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                idle++;
+                changed.wait(lock, [this]() { return stopping || pending.load() > 0 || !concurrentTasks.empty(); });
+                idle--;
+                if (!concurrentTasks.empty()) {
+                    next = concurrentTasks.front();
+                    concurrentTasks.pop_front();
+                } else if (pending.load() == 0) {
+                    return;
+                }
+            }
+            if (next == nullptr) {
+                next = take(own);
+            }
+            if (next != nullptr) {
+                execute(*next);
+            }
+        }
+    }
+};
+
+
+/**
+ * Spinning barrier for a fixed number of threads that meet very often.
+ * Threads yield after a short spin, so it also works on a single core.
+ */
+class spin_barrier {
+    size_t              parties;
+    std::atomic<size_t> waiting { 0 };
+    std::atomic<size_t> generation { 0 };
+
+public:
+    inline explicit spin_barrier(size_t count) noexcept
+        : parties(count) {}
+
+    spin_barrier(const spin_barrier&) = delete;
+    spin_barrier& operator=(const spin_barrier&) = delete;
+
+    inline void arrive_and_wait() noexcept {
+        size_t gen = generation.load(std::memory_order_relaxed);
+        if (waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == parties) {
+            // Last one in releases the others.
+            waiting.store(0, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+
+        for (size_t spins = 0; generation.load(std::memory_order_acquire) == gen; spins++) {
+            if (spins >= 64) {
+                std::this_thread::yield();
+            }
+        }
+    }
+};
+
+}  // namespace utils
+}  // namespace dmp
+
+#endif
@@ -59,7 +59,8 @@ int main(int argc, char **argv) {
 namespace dmp {
 namespace traits {
 
-using string_encoding_char_t = uint16_t;
+// Line indices of the line mode, 32 bits wide to allow for millions of lines.
+using string_encoding_char_t = uint32_t;
 
 template <typename string_type>
 struct string_traits {};
@@ -70,17 +71,21 @@ struct clock_traits {};
 template <typename container_type>
 struct container_traits {};
 
+template <typename executor_type>
+struct executor_traits {};
+
 template <typename char_t>
 struct char_traits {};
 
 }  // namespace traits
 
 
-template <typename _string_traits, typename _clock_traits, typename _container_traits>
+template <typename _string_traits, typename _clock_traits, typename _container_traits, typename _executor_traits = traits::executor_traits<void>>
 struct all_traits {
     using string_traits    = _string_traits;
     using clock_traits     = _clock_traits;
     using container_traits = _container_traits;
+    using executor_traits  = _executor_traits;
 };
 
 }  // namespace dmp
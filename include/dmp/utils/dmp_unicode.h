@@ -54,6 +54,7 @@ int main(int argc, char **argv) {
 #define DIFF_MATCH_PATCH_UNICODE_H
 
 
+#include <cstddef>
 #include <limits>
 #include <type_traits>
 
@@ -192,6 +193,90 @@ struct utf32_from_utf16 {
     }
 };
 
+/**
+ * Decodes the code point starting at data[i] and returns the index after it.
+ * Units of one byte are decoded as UTF-8, units of two bytes as UTF-16 and
+ * wider units as UTF-32.  A malformed sequence yields its first unit.
+ */
+template <class char_t, class utf32_t>
+inline constexpr size_t next_code_point(const char_t* data, size_t len, size_t i, utf32_t& u) noexcept {
+    using uchar_t = std::make_unsigned_t<char_t>;
+
+    u = static_cast<utf32_t>(static_cast<uchar_t>(data[i++]));
+    if constexpr (sizeof(char_t) == 1) {
+        size_t tail = (u >> 5) == 6 ? 1 : (u >> 4) == 0xE ? 2 : (u >> 3) == 0x1E ? 3 : 0;
+        if (tail == 0 || i + tail > len) {
+            return i;
+        }
+        utf32_t v = u & (0x3Fu >> tail);
+        for (size_t k = 0; k < tail; k++) {
+            auto c = static_cast<utf32_t>(static_cast<uchar_t>(data[i + k]));
+            if ((c & 0xC0) != 0x80) {
+                return i;
+            }
+            v = (v << 6) | (c & 0x3F);
+        }
+        u = v;
+        return i + tail;
+    } else if constexpr (sizeof(char_t) == 2) {
+        if (u >= 0xD800 && u <= 0xDBFF && i < len) {
+            auto c = static_cast<utf32_t>(static_cast<uchar_t>(data[i]));
+            if (c >= 0xDC00 && c <= 0xDFFF) {
+                u = 0x10000 + ((u - 0xD800) << 10) + (c - 0xDC00);
+                return i + 1;
+            }
+        }
+        return i;
+    } else {
+        return i;
+    }
+}
+
+/**
+ * Coarse class of a non-ASCII code point, see classify_code_point.
+ */
+enum class code_point_class { letter, space, punctuation };
+
+struct code_point_ranges {
+    static constexpr const unsigned spaces[][2] = {
+        { 0x0085, 0x0085 }, { 0x00A0, 0x00A0 }, { 0x1680, 0x1680 }, { 0x2000, 0x200A },
+        { 0x2028, 0x2029 }, { 0x202F, 0x202F }, { 0x205F, 0x205F }, { 0x3000, 0x3000 },
+    };
+    // Latin-1 and general punctuation, currency, arrows up to dingbats, CJK
+    // and fullwidth punctuation and the emoji blocks.
+    static constexpr const unsigned punctuation[][2] = {
+        { 0x0080, 0x00A9 }, { 0x00AB, 0x00B1 }, { 0x00B4, 0x00B4 }, { 0x00B6, 0x00B8 }, { 0x00BB, 0x00BB },
+        { 0x00BF, 0x00BF }, { 0x00D7, 0x00D7 }, { 0x00F7, 0x00F7 }, { 0x2010, 0x2027 }, { 0x2030, 0x205E },
+        { 0x20A0, 0x20CF }, { 0x2190, 0x2BFF }, { 0x2E00, 0x2E7F }, { 0x3001, 0x3003 }, { 0x3008, 0x3011 },
+        { 0x3014, 0x301F }, { 0xFE10, 0xFE1F }, { 0xFE30, 0xFE4F }, { 0xFF01, 0xFF0F }, { 0xFF1A, 0xFF20 },
+        { 0xFF3B, 0xFF40 }, { 0xFF5B, 0xFF65 }, { 0x1F000, 0x1FAFF },
+    };
+};
+
+/**
+ * Classifies a non-ASCII code point.  Only the spaces and the punctuation and
+ * symbol blocks listed in code_point_ranges are told apart, every other code
+ * point counts as a letter, so scripts written without spaces form a single
+ * word.
+ */
+template <class utf32_t>
+inline constexpr code_point_class classify_code_point(utf32_t u) noexcept {
+    for (auto& range : code_point_ranges::spaces) {
+        if (u >= range[0] && u <= range[1]) {
+            return code_point_class::space;
+        }
+    }
+    for (auto& range : code_point_ranges::punctuation) {
+        if (u < range[0]) {
+            break;
+        }
+        if (u <= range[1]) {
+            return code_point_class::punctuation;
+        }
+    }
+    return code_point_class::letter;
+}
+
 
 }  // namespace utils
 }  // namespace dmp
@@ -58,6 +58,7 @@ int main(int argc, char **argv) {
 #include <iterator>
 #include <limits>
 #include <stdint.h>
+#include <type_traits>
 #include <utility>
 
 namespace std {}
@@ -127,6 +128,47 @@ static inline constexpr bool isSpace(char_t ch) noexcept {
     return false;
 }
 
+/**
+ * Character classes combined by charClass.
+ */
+enum char_class : uint8_t {
+    CHAR_CLASS_NONE      = 0,
+    CHAR_CLASS_ALPHANUM  = 1,
+    CHAR_CLASS_SPACE     = 2,
+    CHAR_CLASS_LINEBREAK = 4,
+};
+
+namespace internal {
+struct char_class_table {
+    uint8_t classes[256] = {};
+
+    inline constexpr char_class_table() noexcept {
+        for (unsigned c = 0; c < 256; c++) {
+            classes[c] = static_cast<uint8_t>((isAlphaNum(c) ? CHAR_CLASS_ALPHANUM : CHAR_CLASS_NONE) |  //
+                                              (isSpace(c) ? CHAR_CLASS_SPACE : CHAR_CLASS_NONE) |        //
+                                              (isControl(c) ? CHAR_CLASS_LINEBREAK : CHAR_CLASS_NONE));
+        }
+    }
+};
+
+inline constexpr char_class_table charClasses{};
+}  // namespace internal
+
+/**
+ * The char_class flags of a character, looked up in a table for the first
+ * 256 code units and classified one by one beyond that.
+ */
+template <typename char_t>
+inline static constexpr uint8_t charClass(char_t chr) noexcept {
+    auto c = static_cast<std::make_unsigned_t<char_t>>(chr);
+    if (sizeof(char_t) == 1 || c < 256) {
+        return internal::charClasses.classes[c];
+    }
+    return static_cast<uint8_t>((isAlphaNum(chr) ? CHAR_CLASS_ALPHANUM : CHAR_CLASS_NONE) |  //
+                                (isSpace(chr) ? CHAR_CLASS_SPACE : CHAR_CLASS_NONE) |        //
+                                (isControl(chr) ? CHAR_CLASS_LINEBREAK : CHAR_CLASS_NONE));
+}
+
 template <typename T, size_t size>
 inline static constexpr size_t array_size(T (&)[size]) noexcept {
     return size;
@@ -52,6 +52,7 @@ int main(int argc, char **argv) {
 
 #include "dmp/traits/dmp_clock_traits_chrono.h"
 #include "dmp/traits/dmp_container_traits_std.h"
+#include "dmp/traits/dmp_executor_traits_threadpool.h"
 #include "dmp/traits/dmp_string_traits_wstring.h"
 
 #include "dmp/diff_match_patch.h"
@@ -140,16 +141,324 @@ int runspeedtest() {
 
     return 0;
 }
+
+
+using parallel_traits = dmp::all_traits<dmp::std_wstring_traits, dmp::chrono_clock_traits, dmp::std_container_traits, dmp::threadpool_executor_traits>;
+using parallel_dmp_t  = dmp::diff_match_patch<parallel_traits>;
+
+int runbisectspeedtest() {
+    // Two texts of 100k characters with an edit about every 30 characters,
+    // so diff_bisect has to walk far on both paths.
+    std::wstring text1;
+    uint32_t     seed = 1;
+    auto         next = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+    for (size_t i = 0; i < 100000; i++) {
+        text1 += static_cast<wchar_t>(L'a' + next() % 26);
+    }
+    std::wstring text2(text1);
+    for (size_t i = 0; i < text2.length(); i += 1 + next() % 60) {
+        text2[i] = static_cast<wchar_t>(L'a' + next() % 26);
+    }
+
+    std::cout << "bisect input lengths: " << text1.length() << " " << text2.length() << "\n";
+
+    dmp_t dmp;
+    dmp.Diff_Timeout = 0;
+
+    parallel_dmp_t parallel_dmp;
+    parallel_dmp.Diff_Timeout           = 0;
+    parallel_dmp.Diff_ParallelThreshold = 0;
+
+    std::wstring delta;
+    {
+        auto ms_start(dmp_t::clock_t::now());
+        auto diffs(dmp.diff_main(text1, text2, false));
+        auto ms_end(dmp_t::clock_t::now());
+
+        std::cout << "Elapsed time for serial bisect: " << ms_start.mSecsTo(ms_end) << " [ms]"
+                  << "\n";
+        delta = dmp.diff_toDelta(diffs);
+    }
+
+    {
+        auto ms_start(parallel_dmp_t::clock_t::now());
+        auto diffs(parallel_dmp.diff_main(text1, text2, false));
+        auto ms_end(parallel_dmp_t::clock_t::now());
+
+        std::cout << "Elapsed time for concurrent bisect: " << ms_start.mSecsTo(ms_end) << " [ms]"
+                  << "\n";
+        if (parallel_dmp.diff_toDelta(diffs) != delta) {
+            std::cout << "concurrent bisect differs\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int runcleanupspeedtest() {
+    // A diff list of about 120k diffs, short equalities between edits, so
+    // the cleanups eliminate and merge a lot of them.  The time should grow
+    // linearly with the number of diffs.
+    uint32_t seed = 1;
+    auto     next = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+    std::wstring text;
+    for (size_t i = 0; i < 400000; i++) {
+        text += static_cast<wchar_t>(L'a' + next() % 4);
+    }
+
+    dmp_t::Diffs diffs;
+    size_t       position = 0;
+    auto         add      = [&](dmp_t::Operation operation, size_t length) {
+        diffs.elements->push_back(dmp_t::Diff(operation, dmp_t::string_view_t(text.data() + position, length)));
+        position += length;
+    };
+    while (position + 16 < text.length()) {
+        // An equality followed by a deletion, an insertion or both.
+        add(dmp_t::Operation::EQUAL, 1 + next() % 8);
+        auto edits(1 + next() % 3);
+        if (edits & 1) {
+            add(dmp_t::Operation::DELETE, 1 + next() % 4);
+        }
+        if (edits & 2) {
+            add(dmp_t::Operation::INSERT, 1 + next() % 4);
+        }
+    }
+
+    std::cout << "cleanup input diffs: " << diffs.elements->size() << "\n";
+
+    dmp_t dmp;
+    auto  text1(dmp.diff_text1(diffs));
+    auto  text2(dmp.diff_text2(diffs));
+
+    const char* names[] { "cleanupMerge", "cleanupSemantic", "cleanupEfficiency", "cleanupSemanticLossless", "cleanup of all three" };
+    for (int cleanup = 0; cleanup < 5; cleanup++) {
+        dmp_t::Diffs cleaned;
+        *cleaned.elements = *diffs.elements;
+
+        auto ms_start(dmp_t::clock_t::now());
+        if (cleanup == 0) {
+            dmp.diff_cleanupMerge(*cleaned.elements, cleaned.stringPool);
+        } else if (cleanup == 1) {
+            dmp.diff_cleanupSemantic(cleaned);
+        } else if (cleanup == 2) {
+            dmp.diff_cleanupEfficiency(cleaned);
+        } else if (cleanup == 3) {
+            dmp.diff_cleanupSemanticLossless(*cleaned.elements, cleaned.stringPool);
+        } else {
+            dmp.diff_cleanup(cleaned, dmp_t::Cleanup::MERGE | dmp_t::Cleanup::SEMANTIC | dmp_t::Cleanup::EFFICIENCY);
+        }
+        auto ms_end(dmp_t::clock_t::now());
+
+        std::cout << "Elapsed time for " << names[cleanup] << ": " << ms_start.mSecsTo(ms_end) << " [ms], " << cleaned.elements->size() << " diffs"
+                  << "\n";
+        if (dmp.diff_text1(cleaned) != text1 || dmp.diff_text2(cleaned) != text2) {
+            std::cout << "cleanup changed the texts\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int rundeltaspeedtest() {
+    // Encode and decode the diffs of the speedtest texts as text and as
+    // binary delta, the binary delta should be smaller and faster.
+    std::wstring text1(speedtest1);
+    std::wstring text2(speedtest2);
+
+    dmp_t dmp;
+    dmp.Diff_Timeout = 0;
+    auto diffs(dmp.diff_main(text1, text2, false));
+
+    const int rounds = 200;
+    for (int binary = 0; binary < 2; binary++) {
+        std::wstring delta;
+        auto         ms_start(dmp_t::clock_t::now());
+        for (int i = 0; i < rounds; i++) {
+            delta = binary ? dmp.diff_toBinaryDelta(diffs) : dmp.diff_toDelta(diffs);
+        }
+        auto ms_encoded(dmp_t::clock_t::now());
+        bool valid = true;
+        for (int i = 0; i < rounds && valid; i++) {
+            auto decoded(binary ? dmp.diff_fromBinaryDelta(text1, delta) : dmp.diff_fromDelta(text1, delta));
+            valid = !decoded.null && decoded == diffs;
+        }
+        auto ms_decoded(dmp_t::clock_t::now());
+
+        std::cout << (binary ? "Binary delta: " : "Text delta: ") << delta.length() << " chars, " << rounds << " encodings "
+                  << ms_start.mSecsTo(ms_encoded) << " [ms], " << rounds << " decodings " << ms_encoded.mSecsTo(ms_decoded) << " [ms]"
+                  << "\n";
+        if (!valid) {
+            std::cout << "delta round trip failed\n";
+            return 1;
+        }
+    }
+
+    // Rebuild text2 from the text delta, through the diff list and directly
+    // into a string.
+    auto         delta(dmp.diff_toDelta(diffs));
+    std::wstring rebuilt;
+    auto         ms_start(dmp_t::clock_t::now());
+    for (int i = 0; i < rounds; i++) {
+        rebuilt = dmp.diff_text2(dmp.diff_fromDelta(text1, delta));
+    }
+    auto ms_listed(dmp_t::clock_t::now());
+    bool valid = rebuilt == text2;
+    for (int i = 0; i < rounds && valid; i++) {
+        rebuilt.clear();
+        valid = dmp.diff_applyDelta(rebuilt, text1, delta);
+    }
+    auto ms_applied(dmp_t::clock_t::now());
+    valid = valid && rebuilt == text2;
+
+    std::cout << "Text delta to text2: " << rounds << " via diffs " << ms_start.mSecsTo(ms_listed) << " [ms], " << rounds << " applied "
+              << ms_listed.mSecsTo(ms_applied) << " [ms]"
+              << "\n";
+    if (!valid) {
+        std::cout << "delta application failed\n";
+        return 1;
+    }
+
+    return 0;
+}
+
+int runprettyhtmlspeedtest() {
+    // Render the diffs of the speedtest texts as HTML, into a stream and
+    // into a buffer of the precomputed size.
+    std::wstring text1(speedtest1);
+    std::wstring text2(speedtest2);
+
+    dmp_t dmp;
+    dmp.Diff_Timeout = 0;
+    auto diffs(dmp.diff_main(text1, text2, false));
+    dmp.diff_cleanupSemantic(diffs);
+
+    const int    rounds = 200;
+    std::wstring html;
+    auto         ms_start(dmp_t::clock_t::now());
+    for (int i = 0; i < rounds; i++) {
+        html = dmp.diff_prettyHtml(diffs);
+    }
+    auto         ms_streamed(dmp_t::clock_t::now());
+    std::wstring buffer;
+    bool         valid = true;
+    for (int i = 0; i < rounds && valid; i++) {
+        size_t size(dmp.diff_prettyHtmlLength(diffs));
+        buffer.resize(size);
+        valid = dmp.diff_prettyHtml(buffer.data(), size, diffs);
+    }
+    auto ms_buffered(dmp_t::clock_t::now());
+    valid = valid && buffer == html;
+
+    std::cout << "Pretty HTML: " << html.length() << " chars, " << rounds << " streamed " << ms_start.mSecsTo(ms_streamed) << " [ms], " << rounds
+              << " buffered " << ms_streamed.mSecsTo(ms_buffered) << " [ms]"
+              << "\n";
+    if (!valid) {
+        std::cout << "buffered HTML differs\n";
+        return 1;
+    }
+
+    return 0;
+}
+
+#ifndef DISABLE_VERY_LONG_STRING_TEST
+int runlinespeedtest() {
+    // Line mode on up to 5M lines with every 1000th line changed, the time
+    // should roughly double with the line count.
+    for (size_t n = 625000; n <= 5000000; n *= 2) {
+        std::wstring text1;
+        std::wstring text2;
+        for (size_t i = 0; i < n; i++) {
+            std::wstring line(L"line " + std::to_wstring(i) + L"\n");
+            text1 += line;
+            text2 += i % 1000 == 500 ? L"changed " + std::to_wstring(i) + L"\n" : line;
+        }
+
+        dmp_t dmp;
+        dmp.Diff_Timeout = 0;
+
+        auto ms_start(dmp_t::clock_t::now());
+        auto diffs(dmp.diff_main(text1, text2, true));
+        auto ms_end(dmp_t::clock_t::now());
+
+        std::cout << "Elapsed time for " << n << " lines: " << ms_start.mSecsTo(ms_end) << " [ms]"
+                  << "\n";
+    }
+
+    return 0;
+}
+
+int runanchorspeedtest() {
+    // Lines with an edit about every 50 lines, diffed with and without
+    // splitting at unique lines first.  Anchored, the time should roughly
+    // double with the line count.
+    uint32_t seed = 1;
+    auto     next = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+    for (size_t n = 125000; n <= 1000000; n *= 2) {
+        std::wstring text1;
+        std::wstring text2;
+        for (size_t i = 0; i < n; i++) {
+            std::wstring line(L"line " + std::to_wstring(i) + L" of the text\n");
+            text1 += line;
+            if (next() % 50 == 0) {
+                line[next() % 5] = L'#';
+            }
+            text2 += line;
+        }
+
+        for (int threshold : { 0, 1 }) {
+            dmp_t dmp;
+            dmp.Diff_Timeout         = 0;
+            dmp.Diff_AnchorThreshold = threshold;
+
+            auto ms_start(dmp_t::clock_t::now());
+            auto diffs(dmp.diff_main(text1, text2, true));
+            auto ms_end(dmp_t::clock_t::now());
+
+            std::cout << "Elapsed time for " << n << " lines" << (threshold ? " anchored: " : ": ") << ms_start.mSecsTo(ms_end) << " [ms]"
+                      << "\n";
+        }
+    }
+
+    return 0;
+}
+#endif
 }  // namespace
 
 #ifdef DEFINE_DIFF_TEST_MAIN
 int main(int /*argc*/, char** /*argv*/) {
     runspeedtest();
+    runbisectspeedtest();
+    runcleanupspeedtest();
+    rundeltaspeedtest();
+    runprettyhtmlspeedtest();
+#    ifndef DISABLE_VERY_LONG_STRING_TEST
+    runlinespeedtest();
+    runanchorspeedtest();
+#    endif
 }
 #else           
 #include <catch2/catch.hpp>
 
     TEST_CASE("speedtest", "speetest") { runspeedtest(); }
+    TEST_CASE("bisect speedtest", "speetest") { REQUIRE(runbisectspeedtest() == 0); }
+    TEST_CASE("cleanup speedtest", "speetest") { REQUIRE(runcleanupspeedtest() == 0); }
+    TEST_CASE("delta speedtest", "speetest") { REQUIRE(rundeltaspeedtest() == 0); }
+    TEST_CASE("pretty html speedtest", "speetest") { REQUIRE(runprettyhtmlspeedtest() == 0); }
+#    ifndef DISABLE_VERY_LONG_STRING_TEST
+    TEST_CASE("line speedtest", "speetest") { runlinespeedtest(); }
+    TEST_CASE("anchor speedtest", "speetest") { runanchorspeedtest(); }
+#    endif
 #endif
 
 #endif
@@ -55,6 +55,7 @@ int main(int argc, char **argv) {
 
 
 #include "dmp/diff_match_patch.h"
+#include "dmp/diff_match_patch_stream.h"
 
 #include "dmp/traits/dmp_encoding_sub_traits.h"
 #include "dmp/utils/dmp_stringwrapper_utils.h"
@@ -99,6 +100,7 @@ struct diff_match_patch_test : public diff_match_patch<all_traits> {
     using Patches   = typename parent::Patches;
 
     using Operation   = typename parent::Operation;
+    using Cleanup     = typename parent::Cleanup;
     using Diff        = typename parent::diff_t;
     using Patch       = typename parent::patch_t;
     using PatchResult = typename parent::patch_result_t;
@@ -119,6 +121,8 @@ struct diff_match_patch_test : public diff_match_patch<all_traits> {
     using ediff_t  = typename parent::encoding_diff_t;
     using ediffs_t = typename parent::encoding_diffs_t;
 
+    using stream_t = diff_match_patch_stream<all_traits>;
+
 public:
     constexpr diff_match_patch_test() noexcept = default;
 
@@ -196,6 +200,14 @@ public:
     }
 
 
+    inline constexpr Diffs diff_bitParallel(string_view_t text1, string_view_t text2, clock_t deadline) const noexcept {
+        Diffs                           container;
+        typename parent::diff_workspace workspace;
+        container.null = !parent::diff_bitParallel(*container.elements, workspace, text1, text2, deadline);
+        return container;
+    }
+
+
     inline static constexpr void diff_rebuildtexts(const Diffs& diffs, owning_string_t& text1, owning_string_t& text2) noexcept {
         using namespace dmp::utils;
 
@@ -81,20 +81,36 @@ DEFINE_TEST(non_allocating, DiffMatchPatch_diff, commonSuffixTest)
 DEFINE_TEST(non_allocating, DiffMatchPatch_diff, commonOverlapTest)
 DEFINE_TEST(non_allocating, DiffMatchPatch_diff, halfmatchTest)
 DEFINE_TEST(non_allocating, DiffMatchPatch_diff, linesToCharsTest)
+DEFINE_TEST(non_allocating, DiffMatchPatch_diff, lineHashTest)
 DEFINE_TEST(non_allocating, DiffMatchPatch_diff, charsToLinesTest)
 DEFINE_TEST(non_allocating, DiffMatchPatch_diff, cleanupMergeTest)
 DEFINE_TEST(non_allocating, DiffMatchPatch_diff, cleanupSemanticLosslessTest)
 DEFINE_TEST(non_allocating, DiffMatchPatch_diff, cleanupSemanticTest)
 DEFINE_TEST(non_allocating, DiffMatchPatch_diff, cleanupEfficiencyTest)
+DEFINE_TEST(non_allocating, DiffMatchPatch_diff, cleanupTest)
 DEFINE_TEST(non_allocating, DiffMatchPatch_diff, prettyHtmlTest)
+DEFINE_TEST(non_allocating, DiffMatchPatch_diff, prettyHtmlWindowTest)
 DEFINE_TEST(non_allocating, DiffMatchPatch_diff, textTest)
 DEFINE_TEST(non_allocating, DiffMatchPatch_diff, deltaTest)
+DEFINE_TEST(non_allocating, DiffMatchPatch_diff, binaryDeltaTest)
+DEFINE_TEST(non_allocating, DiffMatchPatch_diff, applyDeltaTest)
+DEFINE_TEST(non_allocating, DiffMatchPatch_diff, unifiedTest)
 DEFINE_TEST(non_allocating, DiffMatchPatch_diff, xIndexTest)
 DEFINE_TEST(non_allocating, DiffMatchPatch_diff, levenshteinTest)
 DEFINE_TEST(non_allocating, DiffMatchPatch_diff, bisectTest)
 #ifndef _WIN32 // stack overflow on github build server
 DEFINE_TEST(non_allocating, DiffMatchPatch_diff, mainTest)
 #endif
+DEFINE_TEST(non_allocating, DiffMatchPatch_diff, maxWorkTest)
+DEFINE_TEST(non_allocating, DiffMatchPatch_diff, bitParallelTest)
+DEFINE_TEST(non_allocating, DiffMatchPatch_diff, lineAlgorithmTest)
+DEFINE_TEST(non_allocating, DiffMatchPatch_diff, tokenModeTest)
+DEFINE_TEST(non_allocating, DiffMatchPatch_diff, anchoredTest)
+DEFINE_TEST(non_allocating, DiffMatchPatch_diff, rediffTest)
+DEFINE_TEST(non_allocating, DiffMatchPatch_diff, boundedTest)
+DEFINE_TEST(non_allocating, DiffMatchPatch_diff, similarityTest)
+DEFINE_TEST(non_allocating, DiffMatchPatch_diff, workspaceTest)
+DEFINE_TEST(non_allocating, DiffMatchPatch_diff, streamSettleTest)
 
 DEFINE_TEST(non_allocating, DiffMatchPatch_match, alphabetTest)
 DEFINE_TEST(non_allocating, DiffMatchPatch_match, bitapTest)
@@ -55,6 +55,7 @@ int main(int argc, char **argv) {
 
 
 #include "dmp/diff_match_patch.h"
+#include "dmp/diff_match_patch_stream.h"
 
 #include "dmp/traits/dmp_encoding_sub_traits.h"
 #include "dmp/utils/dmp_smallvector.h"
@@ -148,10 +149,15 @@ struct diff_match_patch_test : public dmp::types::settings, public dmp::diff_mat
     using diffs_t = typename parent::diffs_t;
     using Diffs   = container<diffs_t>;
 
+    using diff_workspace = typename parent::diff_workspace;
+    using diff_offsets   = typename parent::diff_offsets;
+    using diff_sketch    = typename parent::diff_sketch;
+
     using patches_t = typename parent::patches_t;
     using Patches   = container<patches_t>;
 
     using Operation   = typename parent::Operation;
+    using Cleanup     = typename parent::Cleanup;
     using Diff        = typename parent::diff_t;
     using Patch       = typename parent::patch_t;
     using PatchResult = typename parent::patch_result_t;
@@ -172,11 +178,21 @@ struct diff_match_patch_test : public dmp::types::settings, public dmp::diff_mat
     using ediff_t  = typename parent::encoding_diff_t;
     using ediffs_t = typename parent::encoding_diffs_t;
 
+    using stream_t = diff_match_patch_stream<all_traits>;
+
     static constexpr const size_t npos = commons::npos;
 
 
     mutable internal_string_pool_t stringPool { nullptr };
 
+    // Shared by the runtime-only wrappers, the workspace is too large for the
+    // stack. A static local cannot be evaluated at compile time, so the
+    // constexpr paths build their own workspace instead.
+    inline static diff_workspace& diffWorkspace() noexcept {
+        static diff_workspace workspace;
+        return workspace;
+    }
+
 public:
     constexpr diff_match_patch_test() noexcept = default;
 
@@ -239,7 +255,7 @@ public:
         stringPool.setOriginalTexts(texts);
 
         container.null = false;
-        parent::diff_main(*this, container.elements, stringPool, text1, text2, true);
+        parent::diff_main(*this, container.elements, stringPool, diffWorkspace(), text1, text2, true);
         stringPool.resetOriginalTexts();
         return container;
     }
@@ -275,6 +291,96 @@ public:
         return container;
     }
 
+    inline constexpr Diffs diff_main(diff_workspace& workspace, string_view_t text1, string_view_t text2, bool checklines = true) const noexcept {
+        Diffs container;
+
+        using original_texts = typename internal_string_pool_t::original_texts;
+        original_texts texts[] { &text1, &text2 };
+
+        stringPool.setOriginalTexts(texts);
+
+        container.null = false;
+        parent::diff_main(*this, container.elements, stringPool, workspace, text1, text2, checklines);
+        stringPool.resetOriginalTexts();
+        return container;
+    }
+
+    /**
+     * Find the differences between two texts if they are at most maxEdits
+     * inserted or deleted characters apart.
+     * @param diffs Receives the diffs, the same as of diff_main.
+     * @param text1 Old string to be diffed.
+     * @param text2 New string to be diffed.
+     * @param maxEdits Maximum number of edits.
+     * @return false if the texts are more than maxEdits edits apart.
+     */
+public:
+    using parent::diff_main_bounded;
+    inline constexpr bool diff_main_bounded(Diffs& diffs, string_view_t text1, string_view_t text2, size_t maxEdits) const noexcept {
+        using original_texts = typename internal_string_pool_t::original_texts;
+        original_texts texts[] { &text1, &text2 };
+
+        stringPool.setOriginalTexts(texts);
+
+        diffs.null  = false;
+        bool result = parent::diff_main_bounded(*this, diffs.elements, stringPool, diffWorkspace(), text1, text2, maxEdits);
+        stringPool.resetOriginalTexts();
+        return result;
+    }
+
+    template <typename tokenizer_t = types::word_tokenizer>
+    inline constexpr Diffs diff_tokens(string_view_t text1, string_view_t text2, const tokenizer_t& tokenizer = tokenizer_t {}) const noexcept {
+        Diffs container;
+
+        using original_texts = typename internal_string_pool_t::original_texts;
+        original_texts texts[] { &text1, &text2 };
+
+        stringPool.setOriginalTexts(texts);
+
+        container.null = false;
+        parent::diff_tokenMode(*this, container.elements, stringPool, diffWorkspace(), text1, text2, tokenizer);
+        stringPool.resetOriginalTexts();
+        return container;
+    }
+
+
+    /**
+     * Update the diffs of text1 and text2 after text2 has been edited.
+     * @param diffs Diffs of text1 and text2 before the edit, updated in place.
+     * @param text1 Old string, unchanged by the edit.
+     * @param text2 New string, text2 after the edit.
+     * @param offset Position of the edit in text2 before the edit.
+     * @param removedLength Number of characters removed at offset.
+     * @param insertedLength Number of characters inserted at offset.
+     * @return false if the edit doesn't match the diffs.
+     */
+public:
+    inline constexpr bool diff_rediff(Diffs& diffs, string_view_t text1, string_view_t text2, size_t offset, size_t removedLength,
+                                      size_t insertedLength) const noexcept {
+        using original_texts = typename internal_string_pool_t::original_texts;
+        original_texts texts[] { &text1, &text2 };
+
+        stringPool.setOriginalTexts(texts);
+
+        bool result = parent::diff_rediff(*this, diffs.elements, stringPool, diffWorkspace(), text1, text2, offset, removedLength, insertedLength);
+        stringPool.resetOriginalTexts();
+        return result;
+    }
+
+
+    /**
+     * Run several cleanups in the order diff_cleanupMerge,
+     * diff_cleanupSemantic or diff_cleanupSemanticLossless, and
+     * diff_cleanupEfficiency.
+     * @param diffs List of Diff objects.
+     * @param cleanups The cleanups to run.
+     */
+public:
+    using parent::diff_cleanup;
+    inline constexpr void diff_cleanup(Diffs& diffs, Cleanup cleanups) const noexcept {
+        parent::diff_cleanup(*this, diffs.elements, stringPool, diffWorkspace(), cleanups);
+    }
+
 
     /**
      * Reduce the number of edits by eliminating semantically trivial
@@ -301,23 +407,59 @@ public:
     inline constexpr void diff_cleanupEfficiency(Diffs& diffs) const noexcept { parent::diff_cleanupEfficiency(*this, diffs.elements, stringPool); }
 
 
+    /**
+     * Count the hunks of a diff, runs of changes with the equality that
+     * follows them.
+     * @param diffs List of Diff objects.
+     * @return Number of hunks.
+     */
+public:
+    inline constexpr size_t diff_hunkCount(const Diffs& diffs) const noexcept { return commons::diff_hunkCount(diffs.elements); }
+    inline constexpr size_t diff_hunkCount(const diffs_t& diffs) const noexcept { return commons::diff_hunkCount(diffs); }
+
+
     /**
      * Convert a Diff list into a pretty HTML report.
      * @param diffs List of Diff objects.
+     * @param firstHunk First hunk to render, see diff_hunkCount.
+     * @param hunkCount Number of hunks to render.
      * @return HTML representation.
      */
 public:
-    inline constexpr owning_string_t diff_prettyHtml(const Diffs& diffs) const noexcept {
+    inline constexpr owning_string_t diff_prettyHtml(const Diffs& diffs, size_t firstHunk = 0, size_t hunkCount = npos) const noexcept {
         stringstream_t s;
-        commons::diff_prettyHtml(s, diffs.elements);
+        commons::diff_prettyHtml(s, diffs.elements, firstHunk, hunkCount);
         return s.str();
     }
-    inline constexpr owning_string_t diff_prettyHtml(const diffs_t& diffs) const noexcept {
+    inline constexpr owning_string_t diff_prettyHtml(const diffs_t& diffs, size_t firstHunk = 0, size_t hunkCount = npos) const noexcept {
         stringstream_t s;
-        commons::diff_prettyHtml(s, diffs);
+        commons::diff_prettyHtml(s, diffs, firstHunk, hunkCount);
         return s.str();
     }
 
+    inline constexpr bool diff_prettyHtml(char_t* buffer, size_t& size, const Diffs& diffs, size_t firstHunk = 0, size_t hunkCount = npos) const noexcept {
+        return commons::diff_prettyHtml(buffer, size, diffs.elements, firstHunk, hunkCount);
+    }
+    inline constexpr bool diff_prettyHtml(char_t* buffer, size_t& size, const diffs_t& diffs, size_t firstHunk = 0, size_t hunkCount = npos) const noexcept {
+        return commons::diff_prettyHtml(buffer, size, diffs, firstHunk, hunkCount);
+    }
+
+
+    /**
+     * Compute the length of the pretty HTML report without building it.
+     * @param diffs List of Diff objects.
+     * @param firstHunk First hunk to render, see diff_hunkCount.
+     * @param hunkCount Number of hunks to render.
+     * @return Length of the HTML representation.
+     */
+public:
+    inline constexpr size_t diff_prettyHtmlLength(const Diffs& diffs, size_t firstHunk = 0, size_t hunkCount = npos) const noexcept {
+        return commons::diff_prettyHtmlLength(diffs.elements, firstHunk, hunkCount);
+    }
+    inline constexpr size_t diff_prettyHtmlLength(const diffs_t& diffs, size_t firstHunk = 0, size_t hunkCount = npos) const noexcept {
+        return commons::diff_prettyHtmlLength(diffs, firstHunk, hunkCount);
+    }
+
 
     /**
      * Crush the diff into an encoded string which describes the operations
@@ -340,6 +482,43 @@ public:
         return s.str();
     }
 
+    /**
+     * Crush the diff into a binary delta.
+     * @param diffs Array of Diff objects.
+     * @return Binary delta.
+     */
+public:
+    inline constexpr owning_string_t diff_toBinaryDelta(const Diffs& diffs) const noexcept {
+        stringstream_t s;
+        commons::diff_toBinaryDelta(s, diffs.elements);
+        return s.str();
+    }
+    inline constexpr owning_string_t diff_toBinaryDelta(const diffs_t& diffs) const noexcept {
+        stringstream_t s;
+        commons::diff_toBinaryDelta(s, diffs);
+        return s.str();
+    }
+
+    /**
+     * Write the diff in the unified format of GNU diff.
+     * @param diffs Array of Diff objects.
+     * @param fromFile Name of text1 for the --- line.
+     * @param toFile Name of text2 for the +++ line.
+     * @param contextLines Number of equal lines around each change.
+     * @return Unified diff.
+     */
+public:
+    inline constexpr owning_string_t diff_toUnified(const Diffs& diffs, string_view_t fromFile, string_view_t toFile, size_t contextLines = 3) const noexcept {
+        stringstream_t s;
+        commons::diff_toUnified(s, diffs.elements, fromFile, toFile, contextLines);
+        return s.str();
+    }
+    inline constexpr owning_string_t diff_toUnified(const diffs_t& diffs, string_view_t fromFile, string_view_t toFile, size_t contextLines = 3) const noexcept {
+        stringstream_t s;
+        commons::diff_toUnified(s, diffs, fromFile, toFile, contextLines);
+        return s.str();
+    }
+
     /**
      * Given the original text1, and an encoded string which describes the
      * operations required to transform text1 into text2, compute the full diff.
@@ -373,6 +552,20 @@ public:
         return container;
     }
 
+    /**
+     * Given the original text1 and a binary delta, compute the full diff.
+     * @param text1 Source string for the diff.
+     * @param delta Binary delta.
+     * @return Array of Diff objects or null if invalid.
+     */
+public:
+    using parent::diff_fromBinaryDelta;
+    inline constexpr Diffs diff_fromBinaryDelta(string_view_t text1, string_view_t delta) const noexcept {
+        Diffs container;
+        container.null = !parent::diff_fromBinaryDelta(container.elements, text1, delta);
+        return container;
+    }
+
 
     /**
      * Compute and return the source text (all equalities and deletions).
@@ -457,6 +650,13 @@ public:
     }
 
 
+    inline constexpr Diffs diff_bitParallel(string_view_t text1, string_view_t text2, clock_t deadline) const noexcept {
+        Diffs container;
+        container.null = !parent::diff_bitParallel(container.elements, diffWorkspace(), text1, text2, deadline);
+        return container;
+    }
+
+
     inline static constexpr void diff_rebuildtexts(const Diffs& diffs, owning_string_t& text1, owning_string_t& text2) noexcept {
         using namespace dmp::utils;
 
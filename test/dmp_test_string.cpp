@@ -73,18 +73,37 @@ DEFINE_TEST(string, DiffMatchPatch_diff, commonSuffixTest)
 DEFINE_TEST(string, DiffMatchPatch_diff, commonOverlapTest)
 DEFINE_TEST(string, DiffMatchPatch_diff, halfmatchTest)
 DEFINE_TEST(string, DiffMatchPatch_diff, linesToCharsTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, lineHashTest)
 DEFINE_TEST(string, DiffMatchPatch_diff, charsToLinesTest)
 DEFINE_TEST(string, DiffMatchPatch_diff, cleanupMergeTest)
 DEFINE_TEST(string, DiffMatchPatch_diff, cleanupSemanticLosslessTest)
 DEFINE_TEST(string, DiffMatchPatch_diff, cleanupSemanticTest)
 DEFINE_TEST(string, DiffMatchPatch_diff, cleanupEfficiencyTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, cleanupTest)
 DEFINE_TEST(string, DiffMatchPatch_diff, prettyHtmlTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, prettyHtmlWindowTest)
 DEFINE_TEST(string, DiffMatchPatch_diff, textTest)
 DEFINE_TEST(string, DiffMatchPatch_diff, deltaTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, binaryDeltaTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, applyDeltaTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, unifiedTest)
 DEFINE_TEST(string, DiffMatchPatch_diff, xIndexTest)
 DEFINE_TEST(string, DiffMatchPatch_diff, levenshteinTest)
 DEFINE_TEST(string, DiffMatchPatch_diff, bisectTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, maxWorkTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, bitParallelTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, lineAlgorithmTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, tokenModeTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, anchoredTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, rediffTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, boundedTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, similarityTest)
 DEFINE_TEST(string, DiffMatchPatch_diff, mainTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, workspaceTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, parallelTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, streamTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, streamSettleTest)
+DEFINE_TEST(string, DiffMatchPatch_diff, mappedFileTest)
 
 DEFINE_TEST(string, DiffMatchPatch_match, alphabetTest)
 DEFINE_TEST(string, DiffMatchPatch_match, bitapTest)
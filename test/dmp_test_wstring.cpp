@@ -73,18 +73,37 @@ DEFINE_TEST(wstring, DiffMatchPatch_diff, commonSuffixTest)
 DEFINE_TEST(wstring, DiffMatchPatch_diff, commonOverlapTest)
 DEFINE_TEST(wstring, DiffMatchPatch_diff, halfmatchTest)
 DEFINE_TEST(wstring, DiffMatchPatch_diff, linesToCharsTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, lineHashTest)
 DEFINE_TEST(wstring, DiffMatchPatch_diff, charsToLinesTest)
 DEFINE_TEST(wstring, DiffMatchPatch_diff, cleanupMergeTest)
 DEFINE_TEST(wstring, DiffMatchPatch_diff, cleanupSemanticLosslessTest)
 DEFINE_TEST(wstring, DiffMatchPatch_diff, cleanupSemanticTest)
 DEFINE_TEST(wstring, DiffMatchPatch_diff, cleanupEfficiencyTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, cleanupTest)
 DEFINE_TEST(wstring, DiffMatchPatch_diff, prettyHtmlTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, prettyHtmlWindowTest)
 DEFINE_TEST(wstring, DiffMatchPatch_diff, textTest)
 DEFINE_TEST(wstring, DiffMatchPatch_diff, deltaTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, binaryDeltaTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, applyDeltaTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, unifiedTest)
 DEFINE_TEST(wstring, DiffMatchPatch_diff, xIndexTest)
 DEFINE_TEST(wstring, DiffMatchPatch_diff, levenshteinTest)
 DEFINE_TEST(wstring, DiffMatchPatch_diff, bisectTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, maxWorkTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, bitParallelTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, lineAlgorithmTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, tokenModeTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, anchoredTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, rediffTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, boundedTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, similarityTest)
 DEFINE_TEST(wstring, DiffMatchPatch_diff, mainTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, workspaceTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, parallelTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, streamTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, streamSettleTest)
+DEFINE_TEST(wstring, DiffMatchPatch_diff, mappedFileTest)
 
 DEFINE_TEST(wstring, DiffMatchPatch_match, alphabetTest)
 DEFINE_TEST(wstring, DiffMatchPatch_match, bitapTest)
@@ -54,8 +54,14 @@ int main(int argc, char **argv) {
 #define DIFF_MATCH_PATCH_TESTS_H
 
 
+#include "dmp/utils/dmp_mappedfile.h"
 #include "dmp/utils/dmp_utils.h"
 
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
 
 #ifndef STR
 // this converts latin1 char strings to the string type used in the test. Since the string might be used outside of a function argument the temp
@@ -106,8 +112,10 @@ struct test_traits {
 
     using HalfMatchResult = typename dmp_t::HalfMatchResult;
     using alphabet_hash_t = typename all_traits::container_traits::template alphabet_hash<char_t, size_t>;
+    using line_hash_t     = typename all_traits::container_traits::template line_hash<string_view_t, size_t>;
 
     using Operation = typename dmp_t::Operation;
+    using Cleanup   = typename dmp_t::Cleanup;
     using Diff      = typename dmp_t::Diff;
     using diffs_t   = typename dmp_t::diffs_t;
     using Diffs     = typename dmp_t::Diffs;
@@ -140,8 +148,10 @@ struct DiffMatchPatch_diff : public test_traits {
     using encoding_list_t           = typename test_traits::encoding_list_t;
 
     using HalfMatchResult = typename test_traits::HalfMatchResult;
+    using line_hash_t     = typename test_traits::line_hash_t;
 
     using Operation = typename test_traits::Operation;
+    using Cleanup   = typename test_traits::Cleanup;
     using Diff      = typename test_traits::Diff;
     using diffs_t   = typename test_traits::diffs_t;
     using Diffs     = typename test_traits::Diffs;
@@ -164,6 +174,8 @@ struct DiffMatchPatch_diff : public test_traits {
         assertEquals("diff_commonPrefix: Non-null case.", 4, dmp.diff_commonPrefix(STR("1234abcdef"), STR("1234xyz")));
 
         assertEquals("diff_commonPrefix: Whole case.", 4, dmp.diff_commonPrefix(STR("1234"), STR("1234xyz")));
+
+        assertEquals("diff_commonPrefix: Long case.", 73, dmp.diff_commonPrefix(STR("0123456789012345678901234567890123456789012345678901234567890123456789abcdef"), STR("0123456789012345678901234567890123456789012345678901234567890123456789abcxyz")));
     }
 
     inline static void commonSuffixTest() {
@@ -177,6 +189,8 @@ struct DiffMatchPatch_diff : public test_traits {
         assertEquals("diff_commonSuffix: Non-null case.", 4, dmp.diff_commonSuffix(STR("abcdef1234"), STR("xyz1234")));
 
         assertEquals("diff_commonSuffix: Whole case.", 4, dmp.diff_commonSuffix(STR("1234"), STR("xyz1234")));
+
+        assertEquals("diff_commonSuffix: Long case.", 73, dmp.diff_commonSuffix(STR("abcdef0123456789012345678901234567890123456789012345678901234567890123456789"), STR("xyzdef0123456789012345678901234567890123456789012345678901234567890123456789")));
     }
 
 
@@ -194,6 +208,14 @@ struct DiffMatchPatch_diff : public test_traits {
 
         assertEquals("diff_commonOverlap: Overlap.", 3, dmp.diff_commonOverlap(STR("123456xxx"), STR("xxxabcd")));
 
+        auto a(STR("aaaaaaaa"));
+        for (size_t i = 0; i < 6; i++) {
+            a = dmp.concat(pool, a, a);
+        }
+        assertEquals("diff_commonOverlap: Long run overlap.", 512, dmp.diff_commonOverlap(dmp.concat(pool, STR("x"), a), dmp.concat(pool, a, STR("y"))));
+        assertEquals("diff_commonOverlap: Interrupted run overlap.", 512,
+                     dmp.diff_commonOverlap(dmp.concat(pool, dmp.concat(pool, a, STR("b")), a), dmp.concat(pool, a, STR("c"))));
+
         // Some overly clever languages (C#) may treat ligatures as equal to their
         // component letters.  E.g. U+FB01 == 'fi'
         assertEquals("diff_commonOverlap: Unicode.", 0, dmp.diff_commonOverlap(STR("fi"), STR("\xEF\xAC\x81i") /*original: "\ufb01i"*/));
@@ -320,6 +342,32 @@ struct DiffMatchPatch_diff : public test_traits {
     }
 
 
+    inline static void lineHashTest() {
+        string_pool_t pool;
+        line_hash_t   hash;
+        assertEquals("line_hash: Insert.", 1u, hash.insertAndReturnValue(STR("alpha\n"), 1));
+        assertEquals("line_hash: Insert.", 2u, hash.insertAndReturnValue(STR("beta\n"), 2));
+        assertEquals("line_hash: Existing.", 1u, hash.insertAndReturnValue(STR("alpha\n"), 3));
+        assertEquals("line_hash: Size.", 2u, hash.size());
+
+        hash.clear();
+        assertEquals("line_hash: Clear.", 0u, hash.size());
+        assertEquals("line_hash: Clear.", 5u, hash.insertAndReturnValue(STR("beta\n"), 5));
+
+        // Enough lines to grow the table.
+        string_view_t text(
+            STR("The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog."));
+        hash.clear();
+        for (size_t i = 1; i <= 100; i++) {
+            hash.insertAndReturnValue(text.substring(0, i), i);
+        }
+        assertEquals("line_hash: Grow.", 100u, hash.size());
+        for (size_t i = 1; i <= 100; i++) {
+            assertEquals("line_hash: Grow.", i, hash.insertAndReturnValue(text.substring(0, i), 0));
+        }
+    }
+
+
     inline static void charsToLinesTest() {
         dmp_t         dmp;
         string_pool_t pool;
@@ -407,6 +455,7 @@ struct DiffMatchPatch_diff : public test_traits {
         encoding_list_t          tmpResult;
         encoding_owning_string_t result[2] {};
         dmp.diff_linesToChars(result, lines, STR(""), tmpResult);
+        assertEquals("diff_linesToChars: More than 65536.", n + 1, tmpResult.size());
         diffs.clear();
         ediffs.clear();
         diffs.reserve(n);
@@ -577,6 +626,20 @@ struct DiffMatchPatch_diff : public test_traits {
                      diffs_t().addAll(Diff(Operation::EQUAL, STR("The xxx.")), Diff(Operation::INSERT, STR(" The zzz.")),
                                       Diff(Operation::EQUAL, STR(" The yyy."))),
                      diffs);
+
+        diffs.clear();
+        diffs.addAll(Diff(Operation::EQUAL, STR("\n\n")), Diff(Operation::DELETE, STR("ab")), Diff(Operation::EQUAL, STR("ab\n")));
+        dmp.diff_cleanupSemanticLossless(diffs, pool);
+        assertEquals("diff_cleanupSemanticLossless: Blank line equality.",
+                     diffs_t().addAll(Diff(Operation::EQUAL, STR("\n\n")), Diff(Operation::DELETE, STR("ab")), Diff(Operation::EQUAL, STR("ab\n"))),
+                     diffs);
+
+        diffs.clear();
+        diffs.addAll(Diff(Operation::EQUAL, STR("\n")), Diff(Operation::DELETE, STR("ab")), Diff(Operation::EQUAL, STR("ab\n")));
+        dmp.diff_cleanupSemanticLossless(diffs, pool);
+        assertEquals("diff_cleanupSemanticLossless: Line break equality.",
+                     diffs_t().addAll(Diff(Operation::EQUAL, STR("\nab")), Diff(Operation::DELETE, STR("ab")), Diff(Operation::EQUAL, STR("\n"))),
+                     diffs);
     }
 
 
@@ -727,6 +790,47 @@ struct DiffMatchPatch_diff : public test_traits {
     }
 
 
+    inline static void cleanupTest() {
+        dmp_t         dmp;
+        string_pool_t pool;
+        (void)pool;
+
+        // Run several cleanups at once.
+        dmp.Diff_EditCost = 4;
+        Diffs diffs;
+        dmp.diff_cleanup(diffs, Cleanup::MERGE | Cleanup::SEMANTIC | Cleanup::EFFICIENCY);
+        assertEquals("diff_cleanup: Null case.", Diffs(), diffs);
+
+        diffs.clear();
+        diffs.addAll(Diff(Operation::DELETE, STR("a")), Diff(Operation::INSERT, STR("b")), Diff(Operation::DELETE, STR("c")), Diff(Operation::INSERT, STR("d")),
+                     Diff(Operation::EQUAL, STR("e")), Diff(Operation::DELETE, STR("f")), Diff(Operation::INSERT, STR("g")));
+        dmp.diff_cleanup(diffs, Cleanup::NONE);
+        assertEquals("diff_cleanup: No cleanup.",
+                     Diffs().addAll(Diff(Operation::DELETE, STR("a")), Diff(Operation::INSERT, STR("b")), Diff(Operation::DELETE, STR("c")),
+                                    Diff(Operation::INSERT, STR("d")), Diff(Operation::EQUAL, STR("e")), Diff(Operation::DELETE, STR("f")),
+                                    Diff(Operation::INSERT, STR("g"))),
+                     diffs);
+
+        dmp.diff_cleanup(diffs, Cleanup::MERGE | Cleanup::SEMANTIC);
+        assertEquals("diff_cleanup: Merge and semantic elimination.",
+                     Diffs().addAll(Diff(Operation::DELETE, STR("acef")), Diff(Operation::INSERT, STR("bdeg"))), diffs);
+
+        diffs.clear();
+        diffs.addAll(Diff(Operation::DELETE, STR("ab")), Diff(Operation::INSERT, STR("12")), Diff(Operation::EQUAL, STR("xyz")),
+                     Diff(Operation::DELETE, STR("cd")), Diff(Operation::INSERT, STR("34")));
+        dmp.diff_cleanup(diffs, Cleanup::SEMANTIC | Cleanup::EFFICIENCY);
+        assertEquals("diff_cleanup: Semantic and efficiency elimination.",
+                     Diffs().addAll(Diff(Operation::DELETE, STR("abxyzcd")), Diff(Operation::INSERT, STR("12xyz34"))), diffs);
+
+        diffs.clear();
+        diffs.addAll(Diff(Operation::EQUAL, STR("The c")), Diff(Operation::INSERT, STR("at c")), Diff(Operation::EQUAL, STR("ame.")));
+        dmp.diff_cleanup(diffs, Cleanup::SEMANTIC_LOSSLESS);
+        assertEquals("diff_cleanup: Semantic lossless.",
+                     Diffs().addAll(Diff(Operation::EQUAL, STR("The ")), Diff(Operation::INSERT, STR("cat ")), Diff(Operation::EQUAL, STR("came."))),
+                     diffs);
+    }
+
+
     inline static void prettyHtmlTest() {
         dmp_t         dmp;
         string_pool_t pool;
@@ -742,6 +846,64 @@ struct DiffMatchPatch_diff : public test_traits {
     }
 
 
+    inline static void prettyHtmlWindowTest() {
+        dmp_t         dmp;
+        string_pool_t pool;
+        (void)pool;
+
+        // Render into a buffer of the precomputed size.
+        diffs_t diffs;
+        diffs.addAll(Diff(Operation::EQUAL, STR("a\n")), Diff(Operation::DELETE, STR("<B>b</B>")), Diff(Operation::INSERT, STR("c&d")));
+        auto html = dmp.diff_prettyHtml(diffs);
+        assertEquals("diff_prettyHtmlLength:", html.length(), dmp.diff_prettyHtmlLength(diffs));
+
+        char_t buffer[512] {};
+        size_t size = dmp::utils::array_size(buffer);
+        assertTrue("diff_prettyHtml: Buffer.", dmp.diff_prettyHtml(buffer, size, diffs));
+        assertEquals("diff_prettyHtml: Buffer.", html, string_view_t(buffer, size));
+
+        size = html.length() - 1;
+        assertFalse("diff_prettyHtml: Small buffer.", dmp.diff_prettyHtml(buffer, size, diffs));
+        assertEquals("diff_prettyHtml: Small buffer.", html.length() - 1, size);
+
+        // Long texts are escaped in vector sized steps, try the specials at all positions.
+        auto text(STR("abcdefghijklmnopq<r&s>t\n"));
+        auto escaped(STR("abcdefghijklmnopq&lt;r&amp;s&gt;t&para;<br>"));
+        for (size_t i = 0; i < 3; i++) {
+            text    = dmp.concat(pool, dmp.concat(pool, text, STR("x")), text);
+            escaped = dmp.concat(pool, dmp.concat(pool, escaped, STR("x")), escaped);
+        }
+        diffs.clear();
+        diffs.addAll(Diff(Operation::EQUAL, text));
+        assertEquals("diff_prettyHtml: Long text.", dmp.concat(pool, dmp.concat(pool, STR("<span>"), escaped), STR("</span>")), dmp.diff_prettyHtml(diffs));
+        assertEquals("diff_prettyHtmlLength: Long text.", escaped.length() + 13, dmp.diff_prettyHtmlLength(diffs));
+
+        // Page through the hunks, a change starts a hunk after an equality.
+        diffs.clear();
+        diffs.addAll(Diff(Operation::EQUAL, STR("a")), Diff(Operation::DELETE, STR("b")), Diff(Operation::INSERT, STR("c")),
+                     Diff(Operation::EQUAL, STR("d")), Diff(Operation::INSERT, STR("e")), Diff(Operation::EQUAL, STR("f")),
+                     Diff(Operation::DELETE, STR("g")));
+        assertEquals("diff_hunkCount:", 3, dmp.diff_hunkCount(diffs));
+        assertEquals("diff_prettyHtml: First hunk.",
+                     STR("<span>a</span><del style=\"background:#ffe6e6;\">b</del><ins style=\"background:#e6ffe6;\">c</ins><span>d</span>"),
+                     dmp.diff_prettyHtml(diffs, 0, 1));
+        assertEquals("diff_prettyHtml: Middle hunk.", STR("<ins style=\"background:#e6ffe6;\">e</ins><span>f</span>"), dmp.diff_prettyHtml(diffs, 1, 1));
+        assertEquals("diff_prettyHtml: Last hunk.", STR("<del style=\"background:#ffe6e6;\">g</del>"), dmp.diff_prettyHtml(diffs, 2, 5));
+        assertEquals("diff_prettyHtml: Past the end.", STR(""), dmp.diff_prettyHtml(diffs, 3, 1));
+        assertEquals("diff_prettyHtml: No hunks.", STR(""), dmp.diff_prettyHtml(diffs, 1, 0));
+        assertEquals("diff_prettyHtml: Pages.", dmp.diff_prettyHtml(diffs),
+                     dmp.concat(pool, dmp.diff_prettyHtml(diffs, 0, 2), dmp.diff_prettyHtml(diffs, 2, 1)));
+        assertEquals("diff_prettyHtmlLength: Middle hunk.", dmp.diff_prettyHtml(diffs, 1, 1).length(), dmp.diff_prettyHtmlLength(diffs, 1, 1));
+
+        diffs.clear();
+        assertEquals("diff_hunkCount: Empty.", 0, dmp.diff_hunkCount(diffs));
+        diffs.addAll(Diff(Operation::EQUAL, STR("a")));
+        assertEquals("diff_hunkCount: Equality.", 1, dmp.diff_hunkCount(diffs));
+        diffs.addAll(Diff(Operation::INSERT, STR("b")));
+        assertEquals("diff_hunkCount: Trailing change.", 1, dmp.diff_hunkCount(diffs));
+    }
+
+
     inline static void textTest() {
         dmp_t         dmp;
         string_pool_t pool;
@@ -880,6 +1042,186 @@ struct DiffMatchPatch_diff : public test_traits {
     }
 
 
+    inline static void binaryDeltaTest() {
+        dmp_t         dmp;
+        string_pool_t pool;
+        (void)pool;
+
+        // Convert a diff into a binary delta.
+        diffs_t diffs;
+        diffs.addAll(Diff(Operation::EQUAL, STR("jump")), Diff(Operation::DELETE, STR("s")), Diff(Operation::INSERT, STR("ed")),
+                     Diff(Operation::EQUAL, STR(" over ")), Diff(Operation::DELETE, STR("the")), Diff(Operation::INSERT, STR("a")),
+                     Diff(Operation::EQUAL, STR(" lazy")), Diff(Operation::INSERT, STR("old dog")));
+        auto text1 = dmp.diff_text1(diffs);
+
+        char_t expected[] = { 16, 5, 10, 'e', 'd', 24, 13, 6, 'a', 20, 30, 'o', 'l', 'd', ' ', 'd', 'o', 'g' };
+        auto   delta      = dmp.diff_toBinaryDelta(diffs);
+        assertEquals("diff_toBinaryDelta:", string_view_t(expected, dmp::utils::array_size(expected)), delta);
+
+        // Convert the binary delta into a diff, the insertions point into it.
+        diffs_t ds;
+        assertTrue("diff_fromBinaryDelta: Normal.", dmp.diff_fromBinaryDelta(ds, text1, delta));
+        assertEquals("diff_fromBinaryDelta: Normal.", diffs, ds);
+        assertTrue("diff_fromBinaryDelta: Views.", ds[2].text.data() == string_view_t(delta).data() + 3);
+
+        // Generates error (19 < 20).
+        assertFalse("diff_fromBinaryDelta: Too long.", dmp.diff_fromBinaryDelta(ds, dmp.concat(pool, text1, STR("x")), delta));
+
+        // Generates error (19 > 18).
+        assertFalse("diff_fromBinaryDelta: Too short.", dmp.diff_fromBinaryDelta(ds, string_view_t(text1).substring(1), delta));
+
+        // Generates error (insertion cut off).
+        assertFalse("diff_fromBinaryDelta: Truncated insertion.", dmp.diff_fromBinaryDelta(ds, text1, string_view_t(delta).substring(0, 17)));
+
+        char_t invalid[] = { 3, static_cast<char_t>(0x80) };
+        assertFalse("diff_fromBinaryDelta: Invalid operation.", dmp.diff_fromBinaryDelta(ds, STR(""), string_view_t(invalid, 1)));
+        assertFalse("diff_fromBinaryDelta: Truncated header.", dmp.diff_fromBinaryDelta(ds, STR(""), string_view_t(invalid + 1, 1)));
+
+        // Special characters are not escaped, long diffs need longer headers.
+        char_t special[] = { 'a', 0, '\t', '%', '\n', static_cast<char_t>(0x80) };
+        auto   a(STR("abcdefghij"));
+        for (size_t i = 0; i < 4; i++) {
+            a = dmp.concat(pool, a, a);
+        }
+        diffs.clear();
+        diffs.addAll(Diff(Operation::EQUAL, a), Diff(Operation::INSERT, string_view_t(special, dmp::utils::array_size(special))));
+        delta = dmp.diff_toBinaryDelta(diffs);
+        assertEquals("diff_toBinaryDelta: Special characters.", 9, delta.length());
+        assertTrue("diff_fromBinaryDelta: Special characters.", dmp.diff_fromBinaryDelta(ds, a, delta));
+        assertEquals("diff_fromBinaryDelta: Special characters.", diffs, ds);
+
+        // Same diffs as from the text delta.
+        auto b(STR("The quick brown fox jumps over the lazy dog."));
+        Diffs main(dmp.diff_main(a, b, false));
+        auto  textDelta = dmp.diff_toDelta(main);
+        delta           = dmp.diff_toBinaryDelta(main);
+        assertTrue("diff_fromBinaryDelta: Text delta.", dmp.diff_fromDelta(ds, pool, a, textDelta));
+        diffs_t binary;
+        assertTrue("diff_fromBinaryDelta: Text delta.", dmp.diff_fromBinaryDelta(binary, a, delta));
+        assertEquals("diff_fromBinaryDelta: Text delta.", ds, binary);
+        assertTrue("diff_toBinaryDelta: Size.", delta.length() < textDelta.length());
+    }
+
+
+    inline static void applyDeltaTest() {
+        dmp_t         dmp;
+        string_pool_t pool;
+        (void)pool;
+
+        // Rebuild text2 from text1 and a delta.
+        diffs_t diffs;
+        diffs.addAll(Diff(Operation::EQUAL, STR("jump")), Diff(Operation::DELETE, STR("s")), Diff(Operation::INSERT, STR("ed")),
+                     Diff(Operation::EQUAL, STR(" over ")), Diff(Operation::DELETE, STR("the")), Diff(Operation::INSERT, STR("a")),
+                     Diff(Operation::EQUAL, STR(" lazy")), Diff(Operation::INSERT, STR("old dog")));
+        auto text1 = dmp.diff_text1(diffs);
+        auto text2 = dmp.diff_text2(diffs);
+        auto delta = dmp.diff_toDelta(diffs);
+
+        assertEquals("diff_deltaLength: Normal.", text2.length(), dmp.diff_deltaLength(text1, delta));
+
+        stringstream_t s;
+        assertTrue("diff_applyDelta: Stream.", dmp.diff_applyDelta(s, text1, delta));
+        assertEquals("diff_applyDelta: Stream.", text2, s.str());
+
+        char_t buffer[64] {};
+        size_t size = dmp::utils::array_size(buffer);
+        assertTrue("diff_applyDelta: Buffer.", dmp.diff_applyDelta(buffer, size, text1, delta));
+        assertEquals("diff_applyDelta: Buffer.", text2, string_view_t(buffer, size));
+
+        // The exact size is enough, one less is not.
+        size = text2.length();
+        assertTrue("diff_applyDelta: Exact buffer.", dmp.diff_applyDelta(buffer, size, text1, delta));
+        size = text2.length() - 1;
+        assertFalse("diff_applyDelta: Small buffer.", dmp.diff_applyDelta(buffer, size, text1, delta));
+
+        // Invalid deltas, like diff_fromDelta.
+        assertEquals("diff_deltaLength: Too long.", dmp_t::npos, dmp.diff_deltaLength(dmp.concat(pool, text1, STR("x")), delta));
+        assertEquals("diff_deltaLength: Too short.", dmp_t::npos, dmp.diff_deltaLength(string_view_t(text1).substring(1), delta));
+        assertEquals("diff_deltaLength: Invalid character.", dmp_t::npos, dmp.diff_deltaLength(STR(""), STR("+%c3%xy")));
+        assertEquals("diff_deltaLength: Truncated escape.", dmp_t::npos, dmp.diff_deltaLength(STR(""), STR("+abc%4")));
+        assertEquals("diff_deltaLength: Invalid operation.", dmp_t::npos, dmp.diff_deltaLength(STR("abc"), STR("=3\t*x")));
+        size = dmp::utils::array_size(buffer);
+        assertFalse("diff_applyDelta: Invalid.", dmp.diff_applyDelta(buffer, size, STR("abc"), STR("=2\t-x")));
+        assertEquals("diff_applyDelta: Invalid.", dmp::utils::array_size(buffer), size);
+
+        // An equality running past text1 isn't passed on.
+        stringstream_t t;
+        assertFalse("diff_applyDelta: Equality too long.", dmp.diff_applyDelta(t, STR("abc"), STR("=5")));
+        assertEquals("diff_applyDelta: Equality too long.", 0u, t.str().length());
+
+        // A string gets text2 appended in one pass, nothing for an invalid delta.
+        owning_string_t rebuilt;
+        assertTrue("diff_applyDelta: String.", dmp.diff_applyDelta(rebuilt, text1, delta));
+        assertEquals("diff_applyDelta: String.", text2, rebuilt);
+        assertFalse("diff_applyDelta: String invalid.", dmp.diff_applyDelta(rebuilt, STR("abc"), STR("=1\t+x\t=5")));
+        assertEquals("diff_applyDelta: String invalid.", text2, rebuilt);
+
+        // Escaped insertions are decoded the same as by diff_fromDelta.
+        auto special(STR("=3\t+%41+%25 %7c%09\t-2"));
+        auto b(STR("abcde"));
+        diffs_t ds;
+        assertTrue("diff_applyDelta: Escapes.", dmp.diff_fromDelta(ds, pool, b, special));
+        text2 = dmp.diff_text2(ds);
+        assertEquals("diff_applyDelta: Escapes.", STR("abcA+% |\t"), text2);
+        assertEquals("diff_deltaLength: Escapes.", text2.length(), dmp.diff_deltaLength(b, special));
+        size = dmp::utils::array_size(buffer);
+        assertTrue("diff_applyDelta: Escapes.", dmp.diff_applyDelta(buffer, size, b, special));
+        assertEquals("diff_applyDelta: Escapes.", text2, string_view_t(buffer, size));
+
+        // Round trip of a real diff.
+        auto a(STR("The quick brown fox jumps over the lazy dog."));
+        b = STR("That quick brown fox jumped over a lazy dog.");
+        Diffs main(dmp.diff_main(a, b, false));
+        auto  mainDelta = dmp.diff_toDelta(main);
+        size            = dmp::utils::array_size(buffer);
+        assertTrue("diff_applyDelta: Round trip.", dmp.diff_applyDelta(buffer, size, a, mainDelta));
+        assertEquals("diff_applyDelta: Round trip.", b, string_view_t(buffer, size));
+    }
+
+
+    inline static void unifiedTest() {
+        dmp_t         dmp;
+        string_pool_t pool;
+        (void)pool;
+
+        // One change with a line of context, the diffs need not end at line ends.
+        diffs_t diffs;
+        diffs.addAll(Diff(Operation::EQUAL, STR("a\nb\nc\n")), Diff(Operation::DELETE, STR("d")), Diff(Operation::INSERT, STR("D")),
+                     Diff(Operation::EQUAL, STR("\ne\nf\ng\nh\n")));
+        assertEquals("diff_toUnified: One hunk.", STR("--- a\n+++ b\n@@ -3,3 +3,3 @@\n c\n-d\n+D\n e\n"), dmp.diff_toUnified(diffs, STR("a"), STR("b"), 1));
+
+        // Changes more than 2 * context lines apart get their own hunks.
+        diffs.clear();
+        diffs.addAll(Diff(Operation::EQUAL, STR("a\n")), Diff(Operation::DELETE, STR("b\n")), Diff(Operation::EQUAL, STR("c\nd\ne\nf\n")),
+                     Diff(Operation::INSERT, STR("G\n")), Diff(Operation::EQUAL, STR("g\nh\n")));
+        assertEquals("diff_toUnified: Two hunks.", STR("--- a\n+++ b\n@@ -1,3 +1,2 @@\n a\n-b\n c\n@@ -6,2 +5,3 @@\n f\n+G\n g\n"),
+                     dmp.diff_toUnified(diffs, STR("a"), STR("b"), 1));
+        assertEquals("diff_toUnified: Joined hunks.", STR("--- a\n+++ b\n@@ -1,8 +1,8 @@\n a\n-b\n c\n d\n e\n f\n+G\n g\n h\n"),
+                     dmp.diff_toUnified(diffs, STR("a"), STR("b"), 2));
+        assertEquals("diff_toUnified: No context.", STR("--- a\n+++ b\n@@ -2 +1,0 @@\n-b\n@@ -6,0 +6 @@\n+G\n"), dmp.diff_toUnified(diffs, STR("a"), STR("b"), 0));
+
+        // Empty texts and missing newlines at the end.
+        diffs.clear();
+        diffs.addAll(Diff(Operation::INSERT, STR("x\ny")));
+        assertEquals("diff_toUnified: From empty.", STR("--- a\n+++ b\n@@ -0,0 +1,2 @@\n+x\n+y\n\\ No newline at end of file\n"),
+                     dmp.diff_toUnified(diffs, STR("a"), STR("b")));
+
+        diffs.clear();
+        diffs.addAll(Diff(Operation::EQUAL, STR("a\n")), Diff(Operation::DELETE, STR("b\n")), Diff(Operation::EQUAL, STR("c")));
+        assertEquals("diff_toUnified: Equal last line.", STR("--- a\n+++ b\n@@ -1,3 +1,2 @@\n a\n-b\n c\n\\ No newline at end of file\n"),
+                     dmp.diff_toUnified(diffs, STR("a"), STR("b")));
+
+        diffs.clear();
+        diffs.addAll(Diff(Operation::EQUAL, STR("a\nb")), Diff(Operation::INSERT, STR("\n")));
+        assertEquals("diff_toUnified: Added newline.", STR("--- a\n+++ b\n@@ -1,2 +1,2 @@\n a\n-b\n\\ No newline at end of file\n+b\n"),
+                     dmp.diff_toUnified(diffs, STR("a"), STR("b")));
+
+        diffs.clear();
+        diffs.addAll(Diff(Operation::EQUAL, STR("a\nb\n")));
+        assertEquals("diff_toUnified: Equal.", STR(""), dmp.diff_toUnified(diffs, STR("a"), STR("b")));
+    }
+
+
     inline static void xIndexTest() {
         dmp_t         dmp;
         string_pool_t pool;
@@ -893,6 +1235,24 @@ struct DiffMatchPatch_diff : public test_traits {
         diffs.clear();
         diffs.addAll(Diff(Operation::EQUAL, STR("a")), Diff(Operation::DELETE, STR("1234")), Diff(Operation::EQUAL, STR("xyz")));
         assertEquals("diff_xIndex: Translation on deletion.", 1, dmp.diff_xIndex(diffs, 3));
+
+        // Prepared offsets translate like the diffs.
+        typename dmp_t::diff_offsets offsets;
+        dmp.diff_xIndexPrepare(diffs, offsets);
+        assertEquals("diff_xIndex: Prepared translation on deletion.", 1, dmp.diff_xIndex(offsets, 3));
+
+        diffs.clear();
+        diffs.addAll(Diff(Operation::DELETE, STR("a")), Diff(Operation::INSERT, STR("1234")), Diff(Operation::EQUAL, STR("xyz")),
+                     Diff(Operation::INSERT, STR("5")), Diff(Operation::DELETE, STR("bc")), Diff(Operation::EQUAL, STR("d")));
+        dmp.diff_xIndexPrepare(diffs, offsets);
+        assertEquals("diff_xIndex: Prepared translation on equality.", 5, dmp.diff_xIndex(offsets, 2));
+        for (size_t loc = 0; loc < 10; loc++) {
+            assertEquals("diff_xIndex: Prepared translation.", dmp.diff_xIndex(diffs, loc), dmp.diff_xIndex(offsets, loc));
+        }
+
+        diffs.clear();
+        dmp.diff_xIndexPrepare(diffs, offsets);
+        assertEquals("diff_xIndex: Prepared null case.", 3, dmp.diff_xIndex(offsets, 3));
     }
 
 
@@ -937,6 +1297,664 @@ struct DiffMatchPatch_diff : public test_traits {
         assertEquals("diff_bisect: Timeout.", diffs, dmp.diff_bisect(a, b, clock_t::now().addMilliseconds(-1)));
     }
 
+    inline static void maxWorkTest() {
+        dmp_t         dmp;
+        string_pool_t pool;
+        (void)pool;
+
+        dmp.Diff_Timeout = 0;
+
+        // Out of work after the first step.
+        dmp.Diff_MaxWork = 1;
+        Diffs diffs;
+        diffs.addAll(Diff(Operation::DELETE, STR("cat")), Diff(Operation::INSERT, STR("map")));
+        assertEquals("diff_bisect: Out of work.", diffs, dmp.diff_bisect(STR("cat"), STR("map"), clock_t()));
+
+        // Texts too long for the bit-parallel diff, without any long equality.
+        auto a(STR("abcdefghijklmnopqrstuvwxyz0123456789"));
+        for (size_t i = 0; i < 3; i++) {
+            a = dmp.concat(pool, a, a);
+        }
+        owning_string_t text1(a.data(), a.length());
+        owning_string_t text2(a.data(), a.length());
+        for (size_t i = 3; i < text2.length(); i += 29) {
+            text2[i] = char_traits::cast('#');
+        }
+
+        typename dmp_t::diff_workspace workspace;
+        dmp.Diff_MaxWork = 0;
+        auto   full(dmp.diff_main(workspace, text1, text2, false));
+        size_t work = workspace.work;
+        assertGreater("diff_main: Work consumed.", work, size_t(0));
+        dmp.diff_main(workspace, text1, text2, false);
+        assertEquals("diff_main: Work consumed again.", work, workspace.work);
+
+        // Half the work yields a valid and reproducible, but longer diff.
+        dmp.Diff_MaxWork = static_cast<int>(work / 2);
+        auto limited(dmp.diff_main(workspace, text1, text2, false));
+        assertLessEqual("diff_main: Work limited.", workspace.work, work);
+        assertEquals("diff_main: Work limited reproducible.", limited, dmp.diff_main(workspace, text1, text2, false));
+        assertGreater("diff_main: Work limited diff.", dmp.diff_levenshtein(limited), dmp.diff_levenshtein(full));
+
+        owning_string_t texts[2] {};
+        dmp.diff_rebuildtexts(limited, texts[0], texts[1]);
+        assertEquals("diff_main: Work limited text1.", text1, texts[0]);
+        assertEquals("diff_main: Work limited text2.", text2, texts[1]);
+    }
+
+
+    inline static void bitParallelTest() {
+        dmp_t         dmp;
+        string_pool_t pool;
+        (void)pool;
+
+        // Normal.
+        Diffs diffs;
+        diffs.addAll(Diff(Operation::DELETE, STR("c")), Diff(Operation::INSERT, STR("m")), Diff(Operation::EQUAL, STR("a")),
+                     Diff(Operation::DELETE, STR("t")), Diff(Operation::INSERT, STR("p")));
+        assertEquals("diff_bitParallel: Normal.", diffs, dmp.diff_bitParallel(STR("cat"), STR("map"), clock_t()));
+
+        // Earliest equality wins.
+        diffs.clear();
+        diffs.addAll(Diff(Operation::EQUAL, STR("a")), Diff(Operation::INSERT, STR("ba")));
+        assertEquals("diff_bitParallel: Early equality.", diffs, dmp.diff_bitParallel(STR("a"), STR("aba"), clock_t()));
+
+        // Multiple words.
+        auto a = STR(
+            "The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. ");
+        auto b = STR("The quick brown fox jumps over the lazy dog. The slow brown fox jumps over the lazy dog. The quick brown fox jumps over the dog. ");
+        diffs = dmp.diff_bitParallel(a, b, clock_t());
+        assertFalse("diff_bitParallel: Multiple words.", diffs.isNull());
+        owning_string_t texts[2] {};
+        dmp.diff_rebuildtexts(diffs, texts[0], texts[1]);
+        assertEquals("diff_bitParallel: Multiple words.", a, texts[0]);
+        assertEquals("diff_bitParallel: Multiple words.", b, texts[1]);
+        assertEquals("diff_bitParallel: Multiple words.", 10, dmp.diff_levenshtein(diffs));
+
+        // Too long.
+        auto c = STR(
+            "1234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890"
+            "1234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890");
+        assertTrue("diff_bitParallel: Too long.", dmp.diff_bitParallel(c, c, clock_t()).isNull());
+
+        // Timeout.
+        assertTrue("diff_bitParallel: Timeout.", dmp.diff_bitParallel(STR("cat"), STR("map"), clock_t::now().addMilliseconds(-1)).isNull());
+    }
+
+
+    inline static void workspaceTest() {
+        dmp_t         dmp;
+        string_pool_t pool;
+        (void)pool;
+
+        dmp.Diff_Timeout = 0;
+        // The workspace is large, keep it off the stack.
+        auto  workspaceStorage(std::make_unique<typename dmp_t::diff_workspace>());
+        auto& workspace(*workspaceStorage);
+
+        // Reusing a workspace yields the same diffs as fresh scratch buffers.
+        auto a = STR(
+            "1234567890\n1234567890\n1234567890\n1234567890\n1234567890\n1234567890\n1234567890\n1234567890\n1234567890\n1234567890\n1234567890\n1234"
+            "567890\n1234567890\n");
+        auto b = STR(
+            "abcdefghij\n1234567890\n1234567890\n1234567890\nabcdefghij\n1234567890\n1234567890\n1234567890\nabcdefghij\n1234567890\n1234567890\n1234"
+            "567890\nabcdefghij\n");
+        assertEquals("diff_main: Workspace line-mode.", dmp.diff_main(a, b, true), dmp.diff_main(workspace, a, b, true));
+        assertEquals("diff_main: Workspace char-mode.", dmp.diff_main(a, b, false), dmp.diff_main(workspace, a, b, false));
+        assertEquals("diff_main: Workspace overlap.", dmp.diff_main(STR("1ayb2"), STR("abxab"), false),
+                     dmp.diff_main(workspace, STR("1ayb2"), STR("abxab"), false));
+        assertEquals("diff_main: Workspace reused.", dmp.diff_main(b, a, true), dmp.diff_main(workspace, b, a, true));
+    }
+
+
+    inline static void parallelTest() {
+        dmp_t         dmp;
+        string_pool_t pool;
+        (void)pool;
+
+        dmp.Diff_Timeout = 0;
+        auto a(STR(
+            "`Twas brillig, and the slithy toves\nDid gyre and gimble in the wabe:\nAll mimsy were the borogoves,\nAnd the mome raths outgrabe.\n"));
+        auto b(
+            STR("I am the very model of a modern major general,\nI've information vegetable, animal, and mineral,\nI know the kings of England, and "
+                "I quote the fights historical,\nFrom Marathon to Waterloo, in order categorical.\n"));
+        for (size_t i = 0; i < 3; i++) {
+            a = dmp.concat(pool, a, b);
+            b = dmp.concat(pool, b, a);
+        }
+
+        auto c(string_view_t(b).substring(1));
+
+        // Forking the sub diffs gives the same result as the serial diff.
+        dmp.Diff_ParallelThreshold       = 0;
+        dmp.Diff_ParallelBisectThreshold = 0;
+        auto serial_chars(dmp.diff_main(a, b, false));
+        auto serial_lines(dmp.diff_main(a, b, true));
+        auto serial_even(dmp.diff_bisect(a, b, clock_t()));
+        auto serial_odd(dmp.diff_bisect(a, c, clock_t()));
+        dmp.Diff_ParallelThreshold = 16;
+        assertEquals("diff_main: Parallel char-mode.", serial_chars, dmp.diff_main(a, b, false));
+        assertEquals("diff_main: Parallel line-mode.", serial_lines, dmp.diff_main(a, b, true));
+
+        // Walking both bisect paths concurrently finds the same middle snakes.
+        dmp.Diff_ParallelThreshold       = 0;
+        dmp.Diff_ParallelBisectThreshold = 1;
+        assertEquals("diff_bisect: Concurrent, even delta.", serial_even, dmp.diff_bisect(a, b, clock_t()));
+        assertEquals("diff_bisect: Concurrent, odd delta.", serial_odd, dmp.diff_bisect(a, c, clock_t()));
+        assertEquals("diff_main: Concurrent bisect.", serial_chars, dmp.diff_main(a, b, false));
+
+        // The anchored segments are diffed in parallel.
+        dmp.Diff_ParallelBisectThreshold = 0;
+        dmp.Diff_AnchorThreshold         = 1;
+        auto d(dmp.concat(pool, b, a));
+        auto serial_anchored(dmp.diff_main(a, d, true));
+        dmp.Diff_ParallelThreshold = 16;
+        assertEquals("diff_main: Parallel anchored.", serial_anchored, dmp.diff_main(a, d, true));
+    }
+
+
+    inline static void anchoredTest() {
+        dmp_t         dmp;
+        string_pool_t pool;
+        (void)pool;
+
+        dmp.Diff_Timeout         = 0;
+        dmp.Diff_AnchorThreshold = 1;
+
+        // The unique line "three" splits the texts.
+        Diffs diffs;
+        diffs.addAll(Diff(Operation::EQUAL, STR("one\n")), Diff(Operation::DELETE, STR("two")), Diff(Operation::INSERT, STR("2")),
+                     Diff(Operation::EQUAL, STR("\nthree\nfour")), Diff(Operation::INSERT, STR("!")), Diff(Operation::EQUAL, STR("\n")));
+        assertEquals("diff_main: Anchored.", diffs, dmp.diff_main(STR("one\ntwo\nthree\nfour\n"), STR("one\n2\nthree\nfour!\n"), true));
+
+        // Repeated lines only, nothing to anchor at.
+        auto a(STR("abc\nabc\nabc\nxyz\nxyz\n"));
+        auto b(STR("xyz\nabc\nxyz\nabc\nxyz\n"));
+        assertEquals("diff_main: Not anchored.", dmp.diff_main(a, b, false), dmp.diff_main(a, b, true));
+
+        a = STR(
+            "`Twas brillig, and the slithy toves\nDid gyre and gimble in the wabe:\nAll mimsy were the borogoves,\nAnd the mome raths outgrabe.\n");
+        b = STR(
+            "I am the very model of a modern major general,\nI've information vegetable, animal, and mineral,\nI know the kings of England, and "
+            "I quote the fights historical,\nFrom Marathon to Waterloo, in order categorical.\n");
+        auto c(dmp.concat(pool, b, a));
+        a = dmp.concat(pool, a, b);
+        b = dmp.concat(pool, b, a);
+        a = dmp.concat(pool, a, STR("The end.\n"));
+        b = dmp.concat(pool, c, b);
+
+        owning_string_t texts[2] {};
+        dmp.diff_rebuildtexts(dmp.diff_main(a, b, true), texts[0], texts[1]);
+        assertEquals("diff_main: Anchored text1.", a, texts[0]);
+        assertEquals("diff_main: Anchored text2.", b, texts[1]);
+    }
+
+    inline static void rediffTest() {
+        dmp_t         dmp;
+        string_pool_t pool;
+        (void)pool;
+
+        dmp.Diff_Timeout = 0;
+
+        auto text1(STR("The quick brown fox jumps over the lazy dog.\nThe five boxing wizards jump quickly.\n"));
+        auto text2(STR("The quick brown fox jumped over the lazy dog.\nThe five boxing wizards jump quickly.\n"));
+
+        // Replace the "s" of "jumps" in text2, text2 is the same as before.
+        Diffs diffs(dmp.diff_main(text1, text2, true));
+        assertTrue("diff_rediff: Replace.", dmp.diff_rediff(diffs, text1, text2, 24, 2, 2));
+        assertEquals("diff_rediff: Replace.", dmp.diff_main(text1, text2, true), diffs);
+
+        // Edit text2 back into text1.
+        assertTrue("diff_rediff: Undo.", dmp.diff_rediff(diffs, text1, text1, 24, 2, 1));
+        Diffs expected;
+        expected.addAll(Diff(Operation::EQUAL, text1));
+        assertEquals("diff_rediff: Undo.", expected, diffs);
+
+        // A series of edits at the start, inside and across diffs and at the end.
+        struct {
+            size_t        offset;
+            size_t        removed;
+            string_view_t inserted;
+        } edits[] { { 0, 0, STR("A") },   { 5, 3, STR("slow") }, { 20, 30, STR("") }, { 10, 1, STR("\nnew line\n") },
+                    { 0, 4, STR("") }, { 40, 0, STR("!") },    { 3, 20, STR("x") } };
+
+        owning_string_t texts[2] {};
+        string_view_t   current(text1);
+        for (auto& edit : edits) {
+            size_t offset = edit.offset < current.length() ? edit.offset : current.length();
+            size_t removed(edit.removed < current.length() - offset ? edit.removed : current.length() - offset);
+            auto&  inserted(edit.inserted);
+            auto   edited(dmp.concat(pool, dmp.concat(pool, current.substring(0, offset), inserted), current.substring(offset + removed)));
+
+            assertTrue("diff_rediff: Edit.", dmp.diff_rediff(diffs, text1, edited, offset, removed, inserted.length()));
+            dmp.diff_rebuildtexts(diffs, texts[0], texts[1]);
+            assertEquals("diff_rediff: Edit text1.", text1, texts[0]);
+            assertEquals("diff_rediff: Edit text2.", edited, texts[1]);
+            assertEquals("diff_rediff: Edit diff_main.", dmp.diff_main(text1, edited, true), diffs);
+            current = edited;
+        }
+
+        // The new diffs merge with the diffs around them.
+        auto text3(STR("QabZ"));
+        auto text4(STR("RabZ"));
+        auto text5(STR("RababZ"));
+        auto text6(STR("RaabbZ"));
+        diffs = dmp.diff_main(text3, text4, true);
+        assertTrue("diff_rediff: Merge.", dmp.diff_rediff(diffs, text3, text5, 1, 0, 2));
+        assertEquals("diff_rediff: Merge.", dmp.diff_main(text3, text5, true), diffs);
+        diffs = dmp.diff_main(text3, text4, true);
+        assertTrue("diff_rediff: Merge inside.", dmp.diff_rediff(diffs, text3, text6, 2, 0, 2));
+        assertEquals("diff_rediff: Merge inside.", dmp.diff_main(text3, text6, true), diffs);
+
+        // Edits at the start and at the end, short texts are diffed again as a whole.
+        struct {
+            string_view_t text1;
+            string_view_t text2;
+            string_view_t edited;
+            size_t        offset;
+            size_t        removed;
+            size_t        inserted;
+        } ends[] { { STR("ab"), STR("b"), STR("ab"), 0, 0, 1 },     { STR("ab"), STR("a"), STR("ab"), 1, 0, 1 },
+                   { STR("abc"), STR("xbc"), STR("bc"), 0, 1, 0 }, { STR("abc"), STR("abx"), STR("ab"), 2, 1, 0 },
+                   { STR("Qab"), STR("ab"), STR("Rab"), 0, 0, 1 }, { STR("abQ"), STR("ab"), STR("abR"), 2, 0, 1 } };
+        for (auto& edit : ends) {
+            diffs = dmp.diff_main(edit.text1, edit.text2, true);
+            assertTrue("diff_rediff: Start or end.", dmp.diff_rediff(diffs, edit.text1, edit.edited, edit.offset, edit.removed, edit.inserted));
+            assertEquals("diff_rediff: Start or end.", dmp.diff_main(edit.text1, edit.edited, true), diffs);
+        }
+
+        // Edits not matching the diffs.
+        diffs = dmp.diff_main(text1, current, true);
+        assertFalse("diff_rediff: Offset too large.", dmp.diff_rediff(diffs, text1, current, current.length() + 1, 0, 0));
+        assertFalse("diff_rediff: Length mismatch.", dmp.diff_rediff(diffs, text1, current, current.length(), 0, 1));
+        assertFalse("diff_rediff: Wrong text1.", dmp.diff_rediff(diffs, text2, current, current.length(), 0, 0));
+    }
+
+    inline static void boundedTest() {
+        dmp_t         dmp;
+        string_pool_t pool;
+        (void)pool;
+
+        dmp.Diff_Timeout = 0;
+
+        // Equal texts need no edits.
+        Diffs diffs;
+        assertTrue("diff_main_bounded: Equality.", dmp.diff_main_bounded(diffs, STR("abc"), STR("abc"), 0));
+        assertEquals("diff_main_bounded: Equality.", dmp.diff_main(STR("abc"), STR("abc"), true), diffs);
+
+        // "kitten" -> "sitting" deletes k and e and inserts s, i and g.
+        assertTrue("diff_main_bounded: Within.", dmp.diff_main_bounded(diffs, STR("kitten"), STR("sitting"), 5));
+        assertEquals("diff_main_bounded: Within.", dmp.diff_main(STR("kitten"), STR("sitting"), true), diffs);
+        assertFalse("diff_main_bounded: Exceeded.", dmp.diff_main_bounded(diffs, STR("kitten"), STR("sitting"), 4));
+        assertEquals("diff_main_bounded: Exceeded.", Diffs(), diffs);
+
+        // The length difference alone exceeds the bound.
+        assertFalse("diff_main_bounded: Lengths.", dmp.diff_main_bounded(diffs, STR("abc"), STR("abcdefgh"), 4));
+        assertTrue("diff_main_bounded: Lengths.", dmp.diff_main_bounded(diffs, STR("abc"), STR("abcdefgh"), 5));
+
+        // Long texts, "jumps" -> "jumped" deletes s and inserts e and d.
+        auto line1(STR("The quick brown fox jumps over the lazy dog.\nThe five boxing wizards jump quickly.\n"));
+        auto line2(STR("The quick brown fox jumped over the lazy dog.\nThe five boxing wizards jump quickly.\n"));
+        auto text1(line1);
+        for (size_t i = 0; i < 3; i++) {
+            text1 = dmp.concat(pool, text1, text1);
+        }
+        auto text2(dmp.concat(pool, text1, line2));
+        text1 = dmp.concat(pool, text1, line1);
+        auto text3(dmp.concat(pool, text1.substring(50), text1.substring(0, 50)));
+        assertTrue("diff_main_bounded: Long within.", dmp.diff_main_bounded(diffs, text1, text2, 3));
+        assertEquals("diff_main_bounded: Long within.", dmp.diff_main(text1, text2, true), diffs);
+        assertFalse("diff_main_bounded: Long exceeded.", dmp.diff_main_bounded(diffs, text1, text2, 2));
+        assertFalse("diff_main_bounded: Long rotated.", dmp.diff_main_bounded(diffs, text1, text3, 40));
+    }
+
+    inline static void similarityTest() {
+        dmp_t         dmp;
+        string_pool_t pool;
+        (void)pool;
+
+        assertTrue("diff_similarity: Null case.", dmp.diff_similarity(STR(""), STR("")) == 1.f);
+        assertTrue("diff_similarity: Empty text.", dmp.diff_similarity(STR(""), STR("abc")) == 0.f);
+        assertTrue("diff_similarity: Equality.", dmp.diff_similarity(STR("abc"), STR("abc")) == 1.f);
+        assertTrue("diff_similarity: Short texts.", dmp.diff_similarity(STR("ab"), STR("abc")) == 0.f);
+        assertTrue("diff_similarity: No common q-grams.", dmp.diff_similarity(STR("abcdefgh"), STR("ijklmnop")) == 0.f);
+
+        auto a(STR(
+            "`Twas brillig, and the slithy toves\nDid gyre and gimble in the wabe:\nAll mimsy were the borogoves,\nAnd the mome raths outgrabe.\n"));
+        auto b(
+            STR("I am the very model of a modern major general,\nI've information vegetable, animal, and mineral,\nI know the kings of England, and "
+                "I quote the fights historical,\nFrom Marathon to Waterloo, in order categorical.\n"));
+        auto c(dmp.concat(pool, a, b));
+        auto d(dmp.concat(pool, dmp.concat(pool, c.substring(0, 100), STR("#")), c.substring(101)));
+
+        // A sketch is reused for any number of comparisons.
+        auto sketch(dmp.diff_makeSketch(c));
+        assertTrue("diff_similarity: Sketch equality.", dmp.diff_similarity(sketch, dmp.diff_makeSketch(c)) == 1.f);
+        assertTrue("diff_similarity: Sketches.", dmp.diff_similarity(sketch, dmp.diff_makeSketch(d)) == dmp.diff_similarity(c, d));
+
+        // One character of 337 replaced changes 4 q-grams.
+        auto similarity(dmp.diff_similarity(c, d));
+        assertTrue("diff_similarity: Similar.", (similarity > 0.9f && similarity < 1.f));
+
+        // Half of the text in common.
+        similarity = dmp.diff_similarity(c, a);
+        assertTrue("diff_similarity: Half.", (similarity > 0.2f && similarity < 0.6f));
+
+        similarity = dmp.diff_similarity(a, b);
+        assertTrue("diff_similarity: Different.", similarity < 0.2f);
+    }
+
+
+    inline static void streamTest() {
+        using namespace dmp::utils;
+        using stream_t = typename dmp_t::stream_t;
+
+        dmp_t         dmp;
+        string_pool_t pool;
+        (void)pool;
+
+        auto a(STR(
+            "`Twas brillig, and the slithy toves\nDid gyre and gimble in the wabe:\nAll mimsy were the borogoves,\nAnd the mome raths outgrabe.\n"));
+        auto b(
+            STR("I am the very model of a modern major general,\nI've information vegetable, animal, and mineral,\nI know the kings of England, and "
+                "I quote the fights historical,\nFrom Marathon to Waterloo, in order categorical.\n"));
+        for (size_t i = 0; i < 4; i++) {
+            a = dmp.concat(pool, a, b);
+            b = dmp.concat(pool, b, a);
+        }
+
+        // text2 is text1 with some characters replaced, removed and inserted.
+        owning_string_t text1(a.data(), a.length());
+        owning_string_t text2(text1);
+        for (size_t i = 37; i < text2.length(); i += 211) {
+            text2[i] = char_traits::cast('#');
+        }
+        text2.erase(1500, 40);
+        text2.insert(3000, text1.substr(100, 300));
+
+        stream_t stream;
+        stream.Diff_Timeout  = 0;
+        stream.Stream_Window = 256;
+        stream.Stream_Anchor = 8;
+
+        owning_string_t texts[2] {};
+        size_t          count = 0;
+
+        auto sink = [&texts, &count](const Diff& diff) {
+            if (diff.operation != Operation::INSERT) {
+                str_append(texts[0], diff.text);
+            }
+            if (diff.operation != Operation::DELETE) {
+                str_append(texts[1], diff.text);
+            }
+            count++;
+        };
+
+        // Feed both texts in chunks, only about a window of each is buffered.
+        string_view_t s1(text1);
+        string_view_t s2(text2);
+        size_t        buffered = 0;
+        for (size_t i = 0; i < s1.length() || i < s2.length(); i += 100) {
+            if (i < s1.length()) {
+                stream.append1(s1.substring(i, (std::min)(s1.length() - i, size_t { 100 })));
+            }
+            if (i < s2.length()) {
+                stream.append2(s2.substring(i, (std::min)(s2.length() - i, size_t { 100 })));
+            }
+            stream.flush(sink);
+            buffered = (std::max)(buffered, stream.bufferedLength());
+        }
+        stream.finish(sink);
+        assertEquals("diff_stream: Text1.", text1, texts[0]);
+        assertEquals("diff_stream: Text2.", text2, texts[1]);
+        assertEquals("diff_stream: Finished.", 0u, stream.bufferedLength());
+        assertTrue("diff_stream: Bounded window.", buffered < 4 * (256 + 100));
+        assertGreater("diff_stream: Edits.", count, 2u);
+
+        // The session can be reused, equal texts give equalities only.
+        bool equal = true;
+        stream.append1(s1);
+        stream.append2(s1);
+        stream.finish([&equal](const Diff& diff) { equal = equal && diff.operation == Operation::EQUAL; });
+        assertTrue("diff_stream: Equal.", equal);
+    }
+
+
+    inline static void streamSettleTest() {
+        using namespace dmp::utils;
+        using stream_t = typename dmp_t::stream_t;
+
+        string_pool_t pool;
+        (void)pool;
+
+        // The stream holds a workspace, keep it off the stack.
+        auto  streamStorage(std::make_unique<stream_t>());
+        auto& stream(*streamStorage);
+        stream.Diff_Timeout  = 0;
+        stream.Stream_Window = 64;
+        stream.Stream_Anchor = 8;
+
+        owning_string_t texts[2] {};
+        size_t          edits    = 0;
+        size_t          buffered = 0;
+
+        auto sink = [&texts, &edits](const Diff& diff) {
+            if (diff.operation != Operation::INSERT) {
+                str_append(texts[0], diff.text);
+            }
+            if (diff.operation != Operation::DELETE) {
+                str_append(texts[1], diff.text);
+            }
+            if (diff.operation != Operation::EQUAL) {
+                edits += diff.text.length();
+            }
+        };
+        auto feed = [&](string_view_t a, string_view_t b) {
+            texts[0].clear();
+            texts[1].clear();
+            edits    = 0;
+            buffered = 0;
+            for (size_t i = 0; i < a.length() || i < b.length(); i += 16) {
+                if (i < a.length()) {
+                    stream.append1(a.substring(i, (std::min)(a.length() - i, size_t { 16 })));
+                }
+                if (i < b.length()) {
+                    stream.append2(b.substring(i, (std::min)(b.length() - i, size_t { 16 })));
+                }
+                stream.flush(sink);
+                buffered = (std::max)(buffered, stream.bufferedLength());
+            }
+            stream.finish(sink);
+        };
+
+        // The equal first window is not settled up to its end, the insertion
+        // behind it is diffed with the following chunks.
+        auto a(STR("The quick brown fox jumps over the lazy dog. The five boxing wizards jump quickly. Pack my box with five dozen liquor jugs."));
+        auto b(STR("The quick brown fox jumps over the lazy dog. The five boxing wizards jump very quickly. Pack my box with five dozen liquor jugs."));
+        feed(a, b);
+        assertEquals("diff_stream: Settle text1.", a, texts[0]);
+        assertEquals("diff_stream: Settle text2.", b, texts[1]);
+        assertEquals("diff_stream: Settle edits.", 5u, edits);
+
+        // Without any equality half a window is settled at a time.
+        a = STR("abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz");
+        b = STR("0123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789");
+        feed(a, b);
+        assertEquals("diff_stream: No anchor text1.", a, texts[0]);
+        assertEquals("diff_stream: No anchor text2.", b, texts[1]);
+        assertEquals("diff_stream: No anchor edits.", a.length() + b.length(), edits);
+        assertTrue("diff_stream: No anchor bounded.", buffered < 4 * (64 + 16));
+    }
+
+
+    inline static void mappedFileTest() {
+        using MappedFile  = typename dmp_t::MappedFile;
+        using mapped_file = dmp::utils::mapped_file;
+
+        dmp_t         dmp;
+        string_pool_t pool;
+        (void)pool;
+
+        auto a(STR("The quick brown fox jumps over the lazy dog.\nThe five boxing wizards jump quickly.\n"));
+        auto b(STR("The quick brown cat jumps over the lazy dog.\nHow vexingly quick daft zebras jump!\n"));
+
+        // Write the texts as they are, so they can be mapped as char_t arrays,
+        // into a temporary directory which is removed again.
+        struct temp_directory {
+            std::filesystem::path path;
+
+            ~temp_directory() {
+                std::error_code ec;
+                std::filesystem::remove_all(path, ec);
+            }
+        } directory { std::filesystem::temp_directory_path() / ("dmp_mapped_" + std::to_string(sizeof(char_t))) };
+        std::filesystem::create_directories(directory.path);
+
+        std::string   names[2] { (directory.path / "1.txt").string(), (directory.path / "2.txt").string() };
+        string_view_t texts[2] { a, b };
+        for (size_t i = 0; i < 2; i++) {
+            std::ofstream out(names[i], std::ios::binary);
+            out.write(reinterpret_cast<const char*>(texts[i].data()), static_cast<std::streamsize>(texts[i].length() * sizeof(char_t)));
+        }
+
+        Diffs diffs;
+        {
+            MappedFile file1(mapped_file::open(names[0].c_str()));
+            MappedFile file2(mapped_file::open(names[1].c_str()));
+            assertTrue("mapped_file: Open.", file1 != nullptr);
+            assertTrue("mapped_file: Open.", file2 != nullptr);
+            assertEquals("mapped_file: Size.", a.length() * sizeof(char_t), file1->size());
+            assertEquals("mapped_file: Text.", a, file1->template text<string_view_t>());
+
+            diffs = dmp.diff_main(file1, file2);
+            assertEquals("diff_main: Mapped files.", dmp.diff_main(a, b), diffs);
+
+            auto patches(dmp.patch_make(file1, file2));
+            assertEquals("patch_apply: Mapped files.", b, dmp.patch_apply(patches, file1).text2);
+
+            // Equalities point into the mapping, nothing is copied.
+            auto text1(file1->template text<string_view_t>());
+            bool views = true;
+            for (auto& d : diffs) {
+                if (d.operation == Operation::EQUAL) {
+                    views = views && d.text.data() >= text1.data() && d.text.data() + d.text.length() <= text1.data() + text1.length();
+                }
+            }
+            assertTrue("diff_main: Mapped views.", views);
+        }
+
+        // The diffs keep the mappings alive.
+        owning_string_t rebuilt[2] {};
+        dmp.diff_rebuildtexts(diffs, rebuilt[0], rebuilt[1]);
+        assertEquals("diff_main: Mapped text1.", a, rebuilt[0]);
+        assertEquals("diff_main: Mapped text2.", b, rebuilt[1]);
+
+        std::remove(names[0].c_str());
+        std::remove(names[1].c_str());
+        assertTrue("mapped_file: Missing file.", mapped_file::open(names[0].c_str()) == nullptr);
+        assertTrue("diff_main: Missing file.", dmp.diff_main(MappedFile {}, MappedFile {}).isNull());
+    }
+
+
+    inline static void lineAlgorithmTest() {
+        dmp_t         dmp;
+        string_pool_t pool;
+        (void)pool;
+
+        dmp.Diff_Timeout = 0;
+        auto a(STR("#include <stdio.h>\n\n// Frobs foo heartily\nint frobnitz(int foo)\n{\n    int i;\n    for(i = 0; i < 10; i++)\n    {\n"
+                   "        printf(\"Your answer is: \");\n        printf(\"%d\\n\", foo);\n    }\n}\n\nint fact(int n)\n{\n    if(n > 1)\n    {\n"
+                   "        return fact(n-1) * n;\n    }\n    return 1;\n}\n\nint main(int argc, char **argv)\n{\n    frobnitz(fact(10));\n}\n"));
+        auto b(STR("#include <stdio.h>\n\nint fib(int n)\n{\n    if(n > 2)\n    {\n        return fib(n-1) + fib(n-2);\n    }\n    return 1;\n}\n\n"
+                   "// Frobs foo heartily\nint frobnitz(int foo)\n{\n    int i;\n    for(i = 0; i < 10; i++)\n    {\n        printf(\"%d\\n\", foo);\n"
+                   "    }\n}\n\nint main(int argc, char **argv)\n{\n    frobnitz(fib(10));\n}\n"));
+
+        Diffs diffs;
+        diffs.addAll(Diff(Operation::EQUAL, STR("#include <stdio.h>\n\n")),
+                     Diff(Operation::INSERT, STR("int fib(int n)\n{\n    if(n > 2)\n    {\n        return fib(n-1) + fib(n-2);\n    }\n    return 1;\n}\n\n")),
+                     Diff(Operation::EQUAL, STR("// Frobs foo heartily\nint frobnitz(int foo)\n{\n    int i;\n    for(i = 0; i < 10; i++)\n    {\n")),
+                     Diff(Operation::DELETE, STR("        printf(\"Your answer is: \");\n")),
+                     Diff(Operation::EQUAL, STR("        printf(\"%d\\n\", foo);\n    }\n}\n\n")),
+                     Diff(Operation::DELETE, STR("int fact(int n)\n{\n    if(n > 1)\n    {\n        return fact(n-1) * n;\n    }\n    return 1;\n}\n\n")),
+                     Diff(Operation::EQUAL, STR("int main(int argc, char **argv)\n{\n    frobnitz(f")), Diff(Operation::DELETE, STR("act")),
+                     Diff(Operation::INSERT, STR("ib")), Diff(Operation::EQUAL, STR("(10));\n}\n")));
+        dmp.Diff_LineAlgorithm = dmp_t::LineDiff::PATIENCE;
+        assertEquals("diff_main: Patience line-mode.", diffs, dmp.diff_main(a, b, true));
+        dmp.Diff_LineAlgorithm = dmp_t::LineDiff::HISTOGRAM;
+        assertEquals("diff_main: Histogram line-mode.", diffs, dmp.diff_main(a, b, true));
+
+        // Repeated lines only, nothing unique to align.
+        a = STR(
+            "1234567890\n1234567890\n1234567890\n1234567890\n1234567890\n1234567890\n1234567890\n1234567890\n1234567890\n1234567890\n1234567890\n1234"
+            "567890\n1234567890\n");
+        b = STR(
+            "abcdefghij\n1234567890\n1234567890\n1234567890\nabcdefghij\n1234567890\n1234567890\n1234567890\nabcdefghij\n1234567890\n1234567890\n1234"
+            "567890\nabcdefghij\n");
+        for (auto algorithm : { dmp_t::LineDiff::PATIENCE, dmp_t::LineDiff::HISTOGRAM }) {
+            dmp.Diff_LineAlgorithm = algorithm;
+            owning_string_t texts[2] {};
+            dmp.diff_rebuildtexts(dmp.diff_main(a, b, true), texts[0], texts[1]);
+            assertEquals("diff_main: Repeated lines.", a, texts[0]);
+            assertEquals("diff_main: Repeated lines.", b, texts[1]);
+        }
+    }
+
+
+    inline static void tokenModeTest() {
+        dmp_t         dmp;
+        string_pool_t pool;
+        (void)pool;
+
+        dmp.Diff_Timeout = 0;
+        auto a(STR("The quick brown fox."));
+        auto b(STR("The quick red fox!"));
+
+        Diffs diffs;
+        diffs.addAll(Diff(Operation::EQUAL, STR("The quick ")), Diff(Operation::DELETE, STR("brown")), Diff(Operation::INSERT, STR("red")),
+                     Diff(Operation::EQUAL, STR(" fox")), Diff(Operation::DELETE, STR(".")), Diff(Operation::INSERT, STR("!")));
+        assertEquals("diff_tokens: Words.", diffs, dmp.diff_tokens(a, b));
+
+        diffs.clear();
+        diffs.addAll(Diff(Operation::EQUAL, STR("The quick ")), Diff(Operation::DELETE, STR("brown fox.")), Diff(Operation::INSERT, STR("red fox!")));
+        assertEquals("diff_tokens: Whitespace.", diffs, dmp.diff_tokens(a, b, dmp::types::whitespace_tokenizer {}));
+
+        // Non-ASCII letters, spaces and punctuation are told apart and never split.
+        bool   utf8(sizeof(char_t) == 1);
+        char_t wide[] = { 'n', 'a', static_cast<char_t>(0xEF), 'v', 'e', static_cast<char_t>(0xA0), 'c', 'a', 'f', static_cast<char_t>(0xE9),
+                          static_cast<char_t>(0xBB) };
+        a = utf8 ? STR("na\xC3\xAFve\xC2\xA0" "caf\xC3\xA9\xC2\xBB") : string_view_t(wide, dmp::utils::array_size(wide));
+        size_t utf8Ends[] = { 6, 8, 13, 15 };
+        size_t wideEnds[] = { 5, 6, 10, 11 };
+        size_t end        = 0;
+        for (size_t k = 0; k < 4; k++) {
+            size_t expected = utf8 ? utf8Ends[k] : wideEnds[k];
+            end             = dmp::types::word_tokenizer {}(a, end);
+            assertEquals("diff_tokens: Non-ASCII.", expected, end);
+        }
+
+        // Single character tokens give the plain character diff.
+        a = STR("The quick brown fox jumps over the lazy dog.");
+        b = STR("That quick brown fox jumped over a lazy dog.");
+        assertEquals("diff_tokens: Characters.", dmp.diff_main(a, b, false),
+                     dmp.diff_tokens(a, b, [](const string_view_t& /*text*/, size_t start) { return start + 1; }));
+
+        // All diffs are views into the original texts.
+        a = STR("int x = foo(a, b);\nreturn x + 1;\n");
+        b = STR("int y = foo(a, c);\nreturn y * 2;\n");
+        auto tokens(dmp.diff_tokens(a, b));
+        bool views = true;
+        for (auto& d : tokens) {
+            auto& text(d.operation == Operation::INSERT ? b : a);
+            views = views && d.text.data() >= text.data() && d.text.data() + d.text.length() <= text.data() + text.length();
+        }
+        assertTrue("diff_tokens: Views.", views);
+
+        owning_string_t texts[2] {};
+        dmp.diff_rebuildtexts(tokens, texts[0], texts[1]);
+        assertEquals("diff_tokens: Text1.", a, texts[0]);
+        assertEquals("diff_tokens: Text2.", b, texts[1]);
+    }
+
 
     inline static void mainTest() {
         dmp_t         dmp;